@@ -0,0 +1,62 @@
+#include <bitonic/simd/simd_sort.hpp>
+#include <bitonic/simd/int32.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+std::mt19937_64 prng{1};
+
+template <typename Functor>
+double time_ms(Functor f) {
+    const auto begin = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+}
+
+// Compares sort_adaptive with sort_range and std::sort on random, sorted and nearly
+// sorted inputs; the context is warmed up so that no timing includes allocations
+template <typename SimdOps>
+void bench_inputs(size_t n) {
+    using value_type = typename SimdOps::value_type;
+    using Sort = Bitonic::SimdSort<SimdOps>;
+
+    std::uniform_int_distribution<value_type> distr;
+    std::vector<value_type> random(n);
+    std::generate(random.begin(), random.end(), [&] { return distr(prng); });
+
+    auto sorted = random;
+    std::sort(sorted.begin(), sorted.end());
+
+    auto nearly = sorted;
+    for(size_t i = 0; i + 1 < n; i += 37)
+        std::swap(nearly[i], nearly[i + 1]);
+
+    Bitonic::SortContext context;
+    auto warmup = random;
+    Sort::sort_range(warmup, context);
+
+    auto run = [&] (const std::string& input, const std::vector<value_type>& data) {
+        auto a = data, b = data, c = data;
+        const double adaptive = time_ms([&] { Sort::sort_adaptive(a, context); });
+        const double range = time_ms([&] { Sort::sort_range(b, context); });
+        const double reference = time_ms([&] { std::sort(c.begin(), c.end()); });
+
+        std::cout << SimdOps::name() << " n=" << n << " " << input
+                  << ": sort_adaptive " << adaptive << " ms, sort_range " << range
+                  << " ms, std::sort " << reference << " ms\n";
+    };
+
+    run("random", random);
+    run("sorted", sorted);
+    run("nearly sorted", nearly);
+}
+
+int main() {
+    bench_inputs<Bitonic::SimdAdapter::SignedInt32>(size_t(1) << 23);
+
+    return 0;
+}
@@ -0,0 +1,60 @@
+#include <bitonic/small_sort.hpp>
+#include <bitonic/simd/int32.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+std::mt19937_64 prng{2};
+
+template <typename Functor>
+double time_ms(Functor f) {
+    const auto begin = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+}
+
+// Sorts many arrays of N elements once by padding each to whole registers and once by
+// transposing kPacking arrays through a comparator network. Lengths beyond kMaxLength,
+// which sort_many hands to the padded path, are marked.
+template <typename SimdOps, size_t N>
+void bench_length(size_t elements) {
+    using value_type = typename SimdOps::value_type;
+
+    const size_t count = elements / N;
+    std::uniform_int_distribution<value_type> distr;
+    std::vector<value_type> data(N * count);
+    std::generate(data.begin(), data.end(), [&] { return distr(prng); });
+
+    auto padded = data;
+    const double padded_ms = time_ms([&] {
+        for(size_t i = 0; i != count; i++)
+            Bitonic::SimdSort<SimdOps>::sort(padded.data() + i * N, padded.data() + (i + 1) * N);
+    });
+
+    auto batched = data;
+    const double batched_ms = time_ms([&] {
+        Bitonic::SmallSort<SimdOps>::template sort_many<N>(batched.data(), count);
+    });
+
+    if (padded != batched) {
+        std::cout << "Mismatch for N=" << N << "\n";
+        std::abort();
+    }
+
+    std::cout << SimdOps::name() << " N=" << N
+              << (N > Bitonic::SmallSort<SimdOps>::kMaxLength ? " (unused)" : "")
+              << ": padded " << padded_ms * 1e6 / count << " ns/array, batched "
+              << batched_ms * 1e6 / count << " ns/array, speedup " << padded_ms / batched_ms << "\n";
+}
+
+int main() {
+    Bitonic::tlx::call_for_range<2, 21>([] (auto n) {
+        bench_length<Bitonic::SimdAdapter::SignedInt32, decltype(n)::index>(size_t(1) << 22);
+    });
+
+    return 0;
+}
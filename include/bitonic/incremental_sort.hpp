@@ -0,0 +1,115 @@
+#pragma once
+
+#include "simd/simd_sort.hpp"
+#include "sort_context.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <utility>
+
+namespace Bitonic {
+
+// Sorts a range lazily from the front (incremental quicksort). Each call to next()
+// partitions only the leftmost unsorted segment until it fits into a sorting network,
+// so a consumer that stops after k elements pays O(n + k log k) expected time.
+// The segment stack lives in the context's kSegmentSlot, so a context must not be shared
+// by two live IncrementalSort objects; other sorts may use it in between.
+template <typename SimdOps_>
+class IncrementalSort {
+    using SimdOps = SimdOps_;
+    using Sort = SimdSort<SimdOps>;
+
+public:
+    using value_type = typename SimdOps::value_type;
+    using block_type = std::pair<value_type*, value_type*>;
+
+    IncrementalSort(value_type* begin, value_type* end, SortContext& context)
+        : begin_(begin), sorted_end_(begin), end_(end), context_(context)
+    {
+        bounds_ = context_.scratch<value_type*>(SortContext::kSegmentSlot, kInitialSegments);
+        capacity_ = context_.capacity(SortContext::kSegmentSlot) / sizeof(value_type*);
+        push(end);
+    }
+
+    template <typename Container>
+    IncrementalSort(Container& container, SortContext& context)
+        : IncrementalSort(std::data(container), std::data(container) + std::size(container), context)
+    {}
+
+    bool done() const {return sorted_end_ == end_;}
+
+    // [begin, sorted_end()) holds the smallest elements of the input in sorted order
+    value_type* sorted_end() const {return sorted_end_;}
+
+    // Sorts the next block of the smallest elements not returned yet; the block is empty iff done()
+    block_type next() {
+        if (done()) return {sorted_end_, sorted_end_};
+
+        while (static_cast<size_t>(back() - sorted_end_) > Sort::kMaxElements) {
+            value_type* const end = back();
+            const value_type pivot = median_of_three(sorted_end_, end);
+
+            auto less = std::partition(sorted_end_, end, [&] (value_type x) {return x < pivot;});
+            auto equal = std::partition(less, end, [&] (value_type x) {return !(pivot < x);});
+
+            if (equal != end) push(equal);
+
+            if (less == sorted_end_) {
+                // elements equal to the pivot are already in their final order
+                return emit(equal);
+            }
+
+            push(less);
+        }
+
+        Sort::sort_range(sorted_end_, back());
+        return emit(back());
+    }
+
+    // Returns once at least the k smallest elements are sorted
+    value_type* sort_prefix(size_t k) {
+        while (static_cast<size_t>(sorted_end_ - begin_) < k && !done())
+            next();
+        return sorted_end_;
+    }
+
+private:
+    constexpr static size_t kInitialSegments = 64;
+
+    value_type* begin_;
+    value_type* sorted_end_;
+    value_type* end_;
+
+    SortContext& context_;
+    value_type** bounds_; // ends of unsorted segments; the leftmost one is at the back
+    size_t size_ = 0;
+    size_t capacity_;
+
+    value_type* back() const {return bounds_[size_ - 1];}
+
+    void push(value_type* bound) {
+        if (size_ == capacity_) {
+            bounds_ = static_cast<value_type**>(
+                context_.grow(SortContext::kSegmentSlot, (size_ + 1) * sizeof(value_type*)));
+            capacity_ = context_.capacity(SortContext::kSegmentSlot) / sizeof(value_type*);
+        }
+        bounds_[size_++] = bound;
+    }
+
+    block_type emit(value_type* end) {
+        block_type block{sorted_end_, end};
+        sorted_end_ = end;
+        if (size_ > 1 && back() == end) size_--;
+        return block;
+    }
+
+    static value_type median_of_three(const value_type* begin, const value_type* end) {
+        const value_type a = *begin;
+        const value_type b = begin[(end - begin) / 2];
+        const value_type c = end[-1];
+        return std::max(std::min(a, b), std::min(std::max(a, b), c));
+    }
+};
+
+}
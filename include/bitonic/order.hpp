@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+namespace Bitonic {
+
+// Key transforms map values to the keys the networks compare. They are involutions,
+// so the same transform applied before storing restores the original values.
+struct IdentityKey {
+    template <typename SimdOps>
+    static typename SimdOps::simd_type apply(typename SimdOps::simd_type x) {return x;}
+
+    template <typename T>
+    constexpr static T apply_scalar(T x) {return x;}
+};
+
+// Flips the bits set in kMask (truncated to the width of the values)
+template <uint64_t kMask>
+struct XorKey {
+    template <typename SimdOps>
+    static typename SimdOps::simd_type apply(typename SimdOps::simd_type x) {
+        using value_type = typename SimdOps::value_type;
+        return SimdOps::bit_xor(x, SimdOps::set1(static_cast<value_type>(kMask)));
+    }
+
+    template <typename T>
+    constexpr static T apply_scalar(T x) {return static_cast<T>(x ^ static_cast<T>(kMask));}
+};
+
+// Reverses the native order of the values
+using InvertKey = XorKey<~uint64_t(0)>;
+
+// Sorts signed values by their unsigned representation and vice versa
+struct FlipSignKey {
+    template <typename T>
+    constexpr static T sign_bit() {
+        using U = std::make_unsigned_t<T>;
+        return static_cast<T>(U(1) << (8 * sizeof(T) - 1));
+    }
+
+    template <typename SimdOps>
+    static typename SimdOps::simd_type apply(typename SimdOps::simd_type x) {
+        using value_type = typename SimdOps::value_type;
+        return SimdOps::bit_xor(x, SimdOps::set1(sign_bit<value_type>()));
+    }
+
+    template <typename T>
+    constexpr static T apply_scalar(T x) {return static_cast<T>(x ^ sign_bit<T>());}
+};
+
+// Order policy of SimdSort: the direction of the networks and the key transform
+// applied to values while they reside in registers
+template <bool kAscending_, typename Key_ = IdentityKey>
+struct Order {
+    constexpr static bool kAscending = kAscending_;
+    using Key = Key_;
+
+    // a value whose key sorts before all others
+    template <typename T>
+    constexpr static T first_value() {
+        return Key::apply_scalar(kAscending ? std::numeric_limits<T>::min() : std::numeric_limits<T>::max());
+    }
+
+    // a value whose key sorts after all others
+    template <typename T>
+    constexpr static T last_value() {
+        return Key::apply_scalar(kAscending ? std::numeric_limits<T>::max() : std::numeric_limits<T>::min());
+    }
+
+    template <typename T>
+    constexpr static bool less(T a, T b) {
+        return kAscending ? Key::apply_scalar(a) < Key::apply_scalar(b)
+                          : Key::apply_scalar(b) < Key::apply_scalar(a);
+    }
+};
+
+using Ascending  = Order<true>;
+using Descending = Order<false>;
+
+}
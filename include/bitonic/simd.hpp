@@ -1,3 +1,4 @@
 #include "simd/simd_sort.hpp"
-#include "simd/int16.hpp"
 #include "simd/int32.hpp"
+#include "simd/int32x4.hpp"
+#include "simd/int64.hpp"
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "simd_adapter.hpp"
+#include "int32x4.hpp"
 
 #include <immintrin.h>
 
@@ -37,6 +38,20 @@ struct Int32Base {
         return _mm256_blend_epi32(a, b, N);
     }
 
+    // true iff all lanes are equal
+    static bool equal(simd_type a, simd_type b) {
+        return _mm256_movemask_epi8(_mm256_cmpeq_epi32(a, b)) == -1;
+    }
+
+    static simd_type bit_xor(simd_type a, simd_type b) {
+        return _mm256_xor_si256(a, b);
+    }
+
+    template<typename value_type>
+    static simd_type set1(value_type x) {
+        return _mm256_set1_epi32(x);
+    }
+
     template<bool kAligned, bool kStream>
     static simd_type load(const simd_type *it) {
         static_assert(!(kStream && !kAligned), "Streaming stores require aligned access");
@@ -70,6 +85,23 @@ struct Int32Base {
         return value;
     };
 
+    template<typename value_type>
+    static simd_type partial_load_high(const simd_type *begin, const size_t offset, const value_type empty_value) {
+        const simd_type index = _mm256_setr_epi32(0,1,2,3,4,5,6,7);
+        const simd_type off = _mm256_set1_epi32(offset);
+        auto mask = _mm256_cmpgt_epi32(off, index); // gives 1 where to skip
+        auto value = _mm256_maskload_epi32(reinterpret_cast<const int*>(begin),
+                                           _mm256_xor_si256(mask, _mm256_set1_epi32(-1)));
+
+        if (empty_value) {
+            auto empty = _mm256_set1_epi32(empty_value);
+            empty = _mm256_and_si256(mask, empty);
+            value = _mm256_or_si256(value, empty);
+        }
+
+        return value;
+    };
+
 
     template<bool kAligned, bool kStream>
     static void store(simd_type *it, const simd_type x) {
@@ -93,6 +125,35 @@ struct Int32Base {
         _mm256_maskstore_epi32(reinterpret_cast<int*>(begin), mask, x);
     };
 
+    static void partial_store_high(simd_type *begin, const size_t offset, const simd_type x) {
+        const simd_type index = _mm256_setr_epi32(0,1,2,3,4,5,6,7);
+        const simd_type off = _mm256_set1_epi32(offset);
+        auto mask = _mm256_cmpgt_epi32(off, index); // gives 1 where to skip
+        _mm256_maskstore_epi32(reinterpret_cast<int*>(begin), _mm256_xor_si256(mask, _mm256_set1_epi32(-1)), x);
+    };
+
+    // transposes the 8x8 matrix whose rows are the registers x[0..8)
+    static void transpose(simd_type* x) {
+        simd_type t[8], u[8];
+
+        for(int i = 0; i != 8; i += 2) {
+            t[i]     = _mm256_unpacklo_epi32(x[i], x[i + 1]);
+            t[i + 1] = _mm256_unpackhi_epi32(x[i], x[i + 1]);
+        }
+
+        for(int i = 0; i != 8; i += 4) {
+            u[i]     = _mm256_unpacklo_epi64(t[i],     t[i + 2]);
+            u[i + 1] = _mm256_unpackhi_epi64(t[i],     t[i + 2]);
+            u[i + 2] = _mm256_unpacklo_epi64(t[i + 1], t[i + 3]);
+            u[i + 3] = _mm256_unpackhi_epi64(t[i + 1], t[i + 3]);
+        }
+
+        for(int i = 0; i != 4; i++) {
+            x[i]     = _mm256_permute2x128_si256(u[i], u[i + 4], 0x20);
+            x[i + 4] = _mm256_permute2x128_si256(u[i], u[i + 4], 0x31);
+        }
+    }
+
     static void print(const simd_type x, std::ostream& os = std::cout) {
         std::stringstream ss;
 
@@ -111,6 +172,7 @@ struct Int32Base {
 
 struct SignedInt32 : public Int32Base {
     using value_type = int32_t;
+    using narrow_type = SignedInt32x4;
 
     static simd_type min(simd_type a, simd_type b) {
         return _mm256_min_epi32(a, b);
@@ -125,6 +187,7 @@ struct SignedInt32 : public Int32Base {
 
 struct UnsignedInt32 : public Int32Base {
     using value_type = uint32_t;
+    using narrow_type = UnsignedInt32x4;
 
     static simd_type min(simd_type a, simd_type b) {
         return _mm256_min_epu32(a, b);
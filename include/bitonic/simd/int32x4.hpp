@@ -0,0 +1,173 @@
+#pragma once
+
+#include "simd_adapter.hpp"
+
+#include <smmintrin.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <iostream>
+#include <sstream>
+#include <string>
+
+namespace Bitonic {
+namespace SimdAdapter {
+
+// 128-bit adapters that only require SSE4.1. Shuffles operate on pairs of lanes,
+// i.e. shuffle<N1, N2> mirrors _MM_SHUFFLE(N1, N2, N3, N4) of the 256-bit adapters.
+struct Int32x4Base {
+    using simd_type = __m128i;
+    constexpr static size_t kPacking = 4;
+
+    template<int N1, int N2>
+    static simd_type shuffle(simd_type x) {
+        return _mm_shuffle_epi32(x, _MM_SHUFFLE(2 + N1, 2 + N2, N1, N2));
+    }
+
+    static simd_type swap_low_high(simd_type x) {
+        return _mm_shuffle_epi32(x, _MM_SHUFFLE(1, 0, 3, 2));
+    }
+
+    static simd_type mirror(simd_type x) {
+        return _mm_shuffle_epi32(x, _MM_SHUFFLE(0, 1, 2, 3));
+    }
+
+    template<int N>
+    static simd_type blend(simd_type a, simd_type b) {
+        return _mm_castps_si128(_mm_blend_ps(_mm_castsi128_ps(a), _mm_castsi128_ps(b), N & 0xf));
+    }
+
+    // true iff all lanes are equal
+    static bool equal(simd_type a, simd_type b) {
+        return _mm_movemask_epi8(_mm_cmpeq_epi32(a, b)) == 0xffff;
+    }
+
+    static simd_type bit_xor(simd_type a, simd_type b) {
+        return _mm_xor_si128(a, b);
+    }
+
+    template<typename value_type>
+    static simd_type set1(value_type x) {
+        return _mm_set1_epi32(x);
+    }
+
+    template<bool kAligned, bool kStream>
+    static simd_type load(const simd_type *it) {
+        static_assert(!(kStream && !kAligned), "Streaming stores require aligned access");
+
+        if constexpr (kStream) {
+            return _mm_stream_load_si128(const_cast<simd_type*>(it));
+        } else {
+            if constexpr (kAligned) {
+                return _mm_load_si128(it);
+            } else {
+                return _mm_loadu_si128(it);
+            }
+        }
+    }
+
+    // SSE4.1 has no masked integer loads/stores, so partial accesses go through the stack
+    template<typename value_type>
+    static simd_type partial_load(const simd_type *begin, const size_t length, const value_type empty_value) {
+        alignas(16) int32_t tmp[kPacking];
+        for(size_t i = length; i != kPacking; i++)
+            tmp[i] = static_cast<int32_t>(empty_value);
+        std::memcpy(tmp, begin, length * sizeof(int32_t));
+        return _mm_load_si128(reinterpret_cast<const simd_type*>(tmp));
+    };
+
+    template<typename value_type>
+    static simd_type partial_load_high(const simd_type *begin, const size_t offset, const value_type empty_value) {
+        alignas(16) int32_t tmp[kPacking];
+        for(size_t i = 0; i != offset; i++)
+            tmp[i] = static_cast<int32_t>(empty_value);
+        std::memcpy(tmp + offset, reinterpret_cast<const int32_t*>(begin) + offset,
+                    (kPacking - offset) * sizeof(int32_t));
+        return _mm_load_si128(reinterpret_cast<const simd_type*>(tmp));
+    };
+
+    template<bool kAligned, bool kStream>
+    static void store(simd_type *it, const simd_type x) {
+        static_assert(!(kStream && !kAligned), "Streaming stores require aligned access");
+
+        if constexpr (kStream) {
+            _mm_stream_si128(it, x);
+        } else {
+            if constexpr (kAligned) {
+                _mm_store_si128(it, x);
+            } else {
+                _mm_storeu_si128(it, x);
+            }
+        }
+    }
+
+    static void partial_store(simd_type *begin, const size_t length, const simd_type x) {
+        alignas(16) int32_t tmp[kPacking];
+        _mm_store_si128(reinterpret_cast<simd_type*>(tmp), x);
+        std::memcpy(begin, tmp, length * sizeof(int32_t));
+    };
+
+    static void partial_store_high(simd_type *begin, const size_t offset, const simd_type x) {
+        alignas(16) int32_t tmp[kPacking];
+        _mm_store_si128(reinterpret_cast<simd_type*>(tmp), x);
+        std::memcpy(reinterpret_cast<int32_t*>(begin) + offset, tmp + offset,
+                    (kPacking - offset) * sizeof(int32_t));
+    };
+
+    // transposes the 4x4 matrix whose rows are the registers x[0..4)
+    static void transpose(simd_type* x) {
+        const auto t0 = _mm_unpacklo_epi32(x[0], x[1]);
+        const auto t1 = _mm_unpacklo_epi32(x[2], x[3]);
+        const auto t2 = _mm_unpackhi_epi32(x[0], x[1]);
+        const auto t3 = _mm_unpackhi_epi32(x[2], x[3]);
+
+        x[0] = _mm_unpacklo_epi64(t0, t1);
+        x[1] = _mm_unpackhi_epi64(t0, t1);
+        x[2] = _mm_unpacklo_epi64(t2, t3);
+        x[3] = _mm_unpackhi_epi64(t2, t3);
+    }
+
+    static void print(const simd_type x, std::ostream& os = std::cout) {
+        std::stringstream ss;
+
+        ss << _mm_extract_epi32(x, 0) << " "
+           << _mm_extract_epi32(x, 1) << " "
+           << _mm_extract_epi32(x, 2) << " "
+           << _mm_extract_epi32(x, 3);
+
+        os << ss.str();
+    }
+};
+
+struct SignedInt32x4 : public Int32x4Base {
+    using value_type = int32_t;
+
+    static simd_type min(simd_type a, simd_type b) {
+        return _mm_min_epi32(a, b);
+    }
+
+    static simd_type max(simd_type a, simd_type b) {
+        return _mm_max_epi32(a, b);
+    }
+
+    static std::string name() {return "SignedInt32x4";}
+};
+
+struct UnsignedInt32x4 : public Int32x4Base {
+    using value_type = uint32_t;
+
+    static simd_type min(simd_type a, simd_type b) {
+        return _mm_min_epu32(a, b);
+    }
+
+    static simd_type max(simd_type a, simd_type b) {
+        return _mm_max_epu32(a, b);
+    }
+
+    static std::string name() {return "UnsignedInt32x4";}
+};
+
+}
+}
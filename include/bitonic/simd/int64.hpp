@@ -0,0 +1,201 @@
+#pragma once
+
+#include "simd_adapter.hpp"
+
+#include <immintrin.h>
+
+#include <cstddef>
+#include <cstdint>
+
+#include <iostream>
+#include <sstream>
+#include <string>
+
+namespace Bitonic {
+namespace SimdAdapter {
+
+// Four 64-bit lanes; shuffles and blends follow the 4-lane conventions of Int32x4Base
+struct Int64Base {
+    using simd_type = __m256i;
+    constexpr static size_t kPacking = 4;
+
+    template<int N1, int N2>
+    static simd_type shuffle(simd_type x) {
+        return _mm256_shuffle_epi32(x, _MM_SHUFFLE(2 * N1 + 1, 2 * N1, 2 * N2 + 1, 2 * N2));
+    }
+
+    static simd_type swap_low_high(simd_type x) {
+        return _mm256_permute2x128_si256(x, x, 0x01);
+    }
+
+    static simd_type mirror(simd_type x) {
+        return _mm256_permute4x64_epi64(x, _MM_SHUFFLE(0, 1, 2, 3));
+    }
+
+    template<int N>
+    static simd_type blend(simd_type a, simd_type b) {
+        // every bit of N selects both 32-bit halves of a lane
+        constexpr int kMask = ((N & 1) ? 0x03 : 0) | ((N & 2) ? 0x0c : 0)
+                            | ((N & 4) ? 0x30 : 0) | ((N & 8) ? 0xc0 : 0);
+        return _mm256_blend_epi32(a, b, kMask);
+    }
+
+    // true iff all lanes are equal
+    static bool equal(simd_type a, simd_type b) {
+        return _mm256_movemask_epi8(_mm256_cmpeq_epi64(a, b)) == -1;
+    }
+
+    static simd_type bit_xor(simd_type a, simd_type b) {
+        return _mm256_xor_si256(a, b);
+    }
+
+    template<typename value_type>
+    static simd_type set1(value_type x) {
+        return _mm256_set1_epi64x(x);
+    }
+
+    template<bool kAligned, bool kStream>
+    static simd_type load(const simd_type *it) {
+        static_assert(!(kStream && !kAligned), "Streaming stores require aligned access");
+
+        if constexpr (kStream) {
+            return _mm256_stream_load_si256(it);
+        } else {
+            if constexpr (kAligned) {
+                return _mm256_load_si256(it);
+            } else {
+                return _mm256_loadu_si256(it);
+            }
+        }
+    }
+
+    template<typename value_type>
+    static simd_type partial_load(const simd_type *begin, const size_t length, const value_type empty_value) {
+        const simd_type index = _mm256_setr_epi64x(0,1,2,3);
+        const simd_type len = _mm256_set1_epi64x(length);
+        auto mask = _mm256_cmpgt_epi64(len, index); // gives 1 where to load
+        auto value = _mm256_maskload_epi64(reinterpret_cast<const long long*>(begin), mask);
+
+        if (empty_value) {
+            auto empty = _mm256_set1_epi64x(empty_value);
+            empty = _mm256_andnot_si256(mask, empty);
+            value = _mm256_or_si256(value, empty);
+        }
+
+        return value;
+    };
+
+    template<typename value_type>
+    static simd_type partial_load_high(const simd_type *begin, const size_t offset, const value_type empty_value) {
+        const simd_type index = _mm256_setr_epi64x(0,1,2,3);
+        const simd_type off = _mm256_set1_epi64x(offset);
+        auto mask = _mm256_cmpgt_epi64(off, index); // gives 1 where to skip
+        auto value = _mm256_maskload_epi64(reinterpret_cast<const long long*>(begin),
+                                           _mm256_xor_si256(mask, _mm256_set1_epi64x(-1)));
+
+        if (empty_value) {
+            auto empty = _mm256_set1_epi64x(empty_value);
+            empty = _mm256_and_si256(mask, empty);
+            value = _mm256_or_si256(value, empty);
+        }
+
+        return value;
+    };
+
+    template<bool kAligned, bool kStream>
+    static void store(simd_type *it, const simd_type x) {
+        static_assert(!(kStream && !kAligned), "Streaming stores require aligned access");
+
+        if constexpr (kStream) {
+            _mm256_stream_si256(it, x);
+        } else {
+            if constexpr (kAligned) {
+                _mm256_store_si256(it, x);
+            } else {
+                _mm256_storeu_si256(it, x);
+            }
+        }
+    }
+
+    static void partial_store(simd_type *begin, const size_t length, const simd_type x) {
+        const simd_type index = _mm256_setr_epi64x(0,1,2,3);
+        const simd_type len = _mm256_set1_epi64x(length);
+        auto mask = _mm256_cmpgt_epi64(len, index); // gives 1 where to load
+        _mm256_maskstore_epi64(reinterpret_cast<long long*>(begin), mask, x);
+    };
+
+    static void partial_store_high(simd_type *begin, const size_t offset, const simd_type x) {
+        const simd_type index = _mm256_setr_epi64x(0,1,2,3);
+        const simd_type off = _mm256_set1_epi64x(offset);
+        auto mask = _mm256_cmpgt_epi64(off, index); // gives 1 where to skip
+        _mm256_maskstore_epi64(reinterpret_cast<long long*>(begin), _mm256_xor_si256(mask, _mm256_set1_epi64x(-1)), x);
+    };
+
+    // transposes the 4x4 matrix whose rows are the registers x[0..4)
+    static void transpose(simd_type* x) {
+        const auto t0 = _mm256_unpacklo_epi64(x[0], x[1]);
+        const auto t1 = _mm256_unpackhi_epi64(x[0], x[1]);
+        const auto t2 = _mm256_unpacklo_epi64(x[2], x[3]);
+        const auto t3 = _mm256_unpackhi_epi64(x[2], x[3]);
+
+        x[0] = _mm256_permute2x128_si256(t0, t2, 0x20);
+        x[1] = _mm256_permute2x128_si256(t1, t3, 0x20);
+        x[2] = _mm256_permute2x128_si256(t0, t2, 0x31);
+        x[3] = _mm256_permute2x128_si256(t1, t3, 0x31);
+    }
+
+    static void print(const simd_type x, std::ostream& os = std::cout) {
+        std::stringstream ss;
+
+        ss << _mm256_extract_epi64(x, 0) << " "
+           << _mm256_extract_epi64(x, 1) << " "
+           << _mm256_extract_epi64(x, 2) << " "
+           << _mm256_extract_epi64(x, 3);
+
+        os << ss.str();
+    }
+};
+
+// AVX2 lacks 64-bit min/max, so both are emulated with a comparison and a blend
+struct SignedInt64 : public Int64Base {
+    using value_type = int64_t;
+
+    static simd_type min(simd_type a, simd_type b) {
+        return _mm256_blendv_epi8(a, b, _mm256_cmpgt_epi64(a, b));
+    }
+
+    static simd_type max(simd_type a, simd_type b) {
+        return _mm256_blendv_epi8(b, a, _mm256_cmpgt_epi64(a, b));
+    }
+
+    static std::string name() {return "SignedInt64";}
+};
+
+struct UnsignedInt64 : public Int64Base {
+    using value_type = uint64_t;
+
+    static simd_type min(simd_type a, simd_type b) {
+        return _mm256_blendv_epi8(a, b, greater(a, b));
+    }
+
+    static simd_type max(simd_type a, simd_type b) {
+        return _mm256_blendv_epi8(b, a, greater(a, b));
+    }
+
+    static std::string name() {return "UnsignedInt64";}
+
+private:
+    static simd_type greater(simd_type a, simd_type b) {
+        const simd_type sign = _mm256_set1_epi64x(static_cast<long long>(1ull << 63));
+        return _mm256_cmpgt_epi64(_mm256_xor_si256(a, sign), _mm256_xor_si256(b, sign));
+    }
+};
+
+template <>
+struct Select<int64_t> {using type = SignedInt64;};
+
+template <>
+struct Select<uint64_t> {using type = UnsignedInt64;};
+
+}
+}
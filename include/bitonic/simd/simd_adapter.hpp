@@ -1,5 +1,7 @@
 #pragma once
 
+#include <type_traits>
+
 namespace Bitonic {
 namespace SimdAdapter {
 
@@ -7,5 +9,17 @@ template<typename T>
 struct Select {
 };
 
+// Adapter with fewer lanes that SimdSort uses for inputs fitting into a single
+// narrow register; adapters opt in by exporting a narrow_type
+template<typename SimdOps, typename = void>
+struct Narrow {
+    using type = SimdOps;
+};
+
+template<typename SimdOps>
+struct Narrow<SimdOps, std::void_t<typename SimdOps::narrow_type>> {
+    using type = typename SimdOps::narrow_type;
+};
+
 }
 }
\ No newline at end of file
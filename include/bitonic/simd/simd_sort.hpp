@@ -1,21 +1,53 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
 #include "../call_for_range.hpp"
+#include "../order.hpp"
+#include "../sort_context.hpp"
+#include "simd_adapter.hpp"
 
+#include <xmmintrin.h>
+
+#include <algorithm>
+#include <iterator>
 #include <limits>
+#include <type_traits>
 
 namespace Bitonic {
 
-template <typename SimdOps_>
+// Order selects the direction and an optional key transform, see order.hpp
+template <typename SimdOps_, typename Order_ = Ascending>
 class SimdSort {
     using SimdOps = SimdOps_;
+    using Order = Order_;
     using value_type = typename SimdOps::value_type;
     using simd_type  = typename SimdOps::simd_type;
 
+    // std::data rejects containers without contiguous storage such as std::deque
+    template <typename Container>
+    using ContiguousData = std::enable_if_t<
+        std::is_same_v<decltype(std::data(std::declval<Container&>())), value_type*>>;
+
 public:
+    constexpr static size_t kMaxRegisters = 32;
+    constexpr static size_t kMaxElements = kMaxRegisters * SimdOps::kPacking;
+
+    // sort_range writes ranges of at least this many bytes with streaming stores in its last
+    // pass, i.e. the final merge or, for ranges of at most kMaxElements, the network
+    constexpr static size_t kDefaultStreamThreshold = 256 * 1024;
+
     template <bool kAligned = false, bool kStream = false>
     static void sort(value_type* begin, value_type* end) {
+        using NarrowOps = typename SimdAdapter::Narrow<SimdOps>::type;
+        if constexpr (NarrowOps::kPacking < SimdOps::kPacking) {
+            // a single narrow register avoids sorting mostly padding
+            if (static_cast<size_t>(end - begin) <= NarrowOps::kPacking) {
+                SimdSort<NarrowOps, Order>::template sort<kAligned, kStream>(begin, end);
+                return;
+            }
+        }
+
         const size_t regs = ((end - begin) + SimdOps::kPacking  - 1) / SimdOps::kPacking;
 
         switch(regs) {
@@ -67,33 +99,391 @@ public:
         if ( !partial_size ) {
             load<k, kAligned, kStream>(packed_it, registers);
         } else {
-            registers[k-1] = SimdOps::partial_load(packed_it + (k-1), partial_size,
-                                                   std::numeric_limits<value_type>::max());
+            registers[k-1] = encode(SimdOps::partial_load(packed_it + (k-1), partial_size,
+                                                          Order::template last_value<value_type>()));
             load<k-1, kAligned, kStream>(packed_it, registers);
         }
 
-        Sorter<k, true>::sort(registers);
+        Sorter<k, Order::kAscending>::sort(registers);
 
         if ( !partial_size ) {
             store<k, kAligned, kStream>(packed_it, registers);
         } else {
             store<k-1, kAligned, kStream>(packed_it, registers);
-            SimdOps::partial_store(packed_it + (k-1), partial_size, registers[k-1]);
+            SimdOps::partial_store(packed_it + (k-1), partial_size, encode(registers[k-1]));
+        }
+    }
+
+    // Sorts the range [begin, end) with arbitrary alignment; iterators other than pointers
+    // are rejected as they need not be contiguous. The unaligned head and tail are
+    // peeled into masked registers, all other registers use aligned accesses (streaming
+    // ones if the range exceeds kStreamThreshold bytes, fenced before returning). Ranges
+    // beyond kMaxElements are sorted with a temporary SortContext; pass one explicitly to
+    // avoid its allocations.
+    template <size_t kStreamThreshold = kDefaultStreamThreshold>
+    static void sort_range(value_type* begin, value_type* end) {
+        const auto n = static_cast<size_t>(end - begin);
+        if (!n) return;
+
+        if (n > kMaxElements) {
+            SortContext context;
+            sort_range<kStreamThreshold>(begin, end, context);
+            return;
+        }
+
+        if (n * sizeof(value_type) >= kStreamThreshold) {
+            sort_peeled<true>(begin, end);
+            _mm_sfence();
+        } else {
+            sort_peeled<false>(begin, end);
+        }
+    }
+
+    template <size_t kStreamThreshold = kDefaultStreamThreshold, typename Container,
+              typename = ContiguousData<Container>>
+    static void sort_range(Container& container) {
+        sort_range<kStreamThreshold>(std::data(container), std::data(container) + std::size(container));
+    }
+
+    // Sorts a contiguous range of arbitrary size. Blocks of up to kMaxElements elements are
+    // sorted by the networks and then merged by the bitonic merger, see merge_pair, using the
+    // context's scratch memory; once the context has seen a job of this size, no further
+    // allocations take place. Only the final merge pass streams its output, as the blocks
+    // are read back right away.
+    template <size_t kStreamThreshold = kDefaultStreamThreshold>
+    static void sort_range(value_type* begin, value_type* end, SortContext& context) {
+        const auto n = static_cast<size_t>(end - begin);
+        if (!n) return;
+
+        if (n * sizeof(value_type) >= kStreamThreshold) {
+            sort_large<true>(begin, end, context);
+            _mm_sfence();
+        } else {
+            sort_large<false>(begin, end, context);
+        }
+    }
+
+    template <size_t kStreamThreshold = kDefaultStreamThreshold, typename Container,
+              typename = ContiguousData<Container>>
+    static void sort_range(Container& container, SortContext& context) {
+        sort_range<kStreamThreshold>(std::data(container), std::data(container) + std::size(container), context);
+    }
+
+    template <bool kStream>
+    static void sort_large(value_type* begin, value_type* end, SortContext& context) {
+        const size_t n = end - begin;
+        if (n <= kMaxElements) {
+            sort_peeled<kStream>(begin, end);
+            return;
+        }
+
+        // the first block ends on an aligned address, so all later blocks are peeled only at the tail
+        constexpr size_t kAlignment = sizeof(simd_type);
+        const auto misalignment = reinterpret_cast<std::uintptr_t>(begin) % kAlignment;
+        const size_t head = misalignment ? (kAlignment - misalignment) / sizeof(value_type) : 0;
+        const size_t first_block = head ? head + kMaxElements - SimdOps::kPacking : kMaxElements;
+
+        const size_t runs = first_block >= n ? 1 : 1 + (n - first_block + kMaxElements - 1) / kMaxElements;
+        auto bounds = context.scratch<size_t>(SortContext::kRunSlot, runs + 1);
+
+        bounds[0] = 0;
+        for(size_t r = 1; r <= runs; r++)
+            bounds[r] = std::min(n, first_block + (r - 1) * kMaxElements);
+
+        for(size_t r = 0; r != runs; r++)
+            sort_peeled<false>(begin + bounds[r], begin + bounds[r + 1]);
+
+        merge_runs<kStream>(begin, bounds, runs, context);
+    }
+
+    // Sorts a contiguous range exploiting existing order: maximal ascending and descending
+    // runs are detected with vector compares and those opposing Order are reversed in place.
+    // Stretches shorter than kMaxElements are extended and sorted by the networks, and
+    // runs that already continue each other are fused before merging. Presorted inputs
+    // thus cost a single scan.
+    static void sort_adaptive(value_type* first, value_type* last, SortContext& context) {
+        const auto n = static_cast<size_t>(last - first);
+        if (n < 2) return;
+
+        // every run but the last one spans at least kMaxElements elements
+        auto bounds = context.scratch<size_t>(SortContext::kRunSlot, n / kMaxElements + 2);
+        size_t runs = 0;
+        bounds[0] = 0;
+
+        for(size_t i = 0; i != n; ) {
+            size_t run_end = find_run(first, i, n);
+
+            if (run_end - i < kMaxElements) {
+                run_end = std::min(n, i + kMaxElements);
+                sort_peeled<false>(first + i, first + run_end);
+            }
+
+            if (runs && !Order::less(first[i], first[i - 1])) {
+                bounds[runs] = run_end; // continues the previous run
+            } else {
+                bounds[++runs] = run_end;
+            }
+
+            i = run_end;
+        }
+
+        merge_runs<false>(first, bounds, runs, context);
+    }
+
+    template <typename Container, typename = ContiguousData<Container>>
+    static void sort_adaptive(Container& container, SortContext& context) {
+        sort_adaptive(std::data(container), std::data(container) + std::size(container), context);
+    }
+
+    // Merges the sorted runs [begin + bounds[i], begin + bounds[i+1]) for i < runs pairwise
+    // with merge_pair. The input is moved to the scratch memory first if that makes the last
+    // pass write to begin; only this pass uses streaming stores if kStream is set. The bounds
+    // are overwritten.
+    template <bool kStream>
+    static void merge_runs(value_type* begin, size_t* bounds, size_t runs, SortContext& context) {
+        if (runs < 2) return;
+
+        size_t passes = 0;
+        for(size_t r = runs; r > 1; r = (r + 1) / 2)
+            passes++;
+
+        const size_t n = bounds[runs];
+        value_type* source = begin;
+        value_type* target = context.scratch<value_type>(SortContext::kMergeSlot, n);
+
+        if (passes % 2) {
+            std::copy(begin, begin + n, target);
+            std::swap(source, target);
+        }
+
+        while (runs > 1) {
+            if (runs == 2) {
+                merge_pair<kStream>(source, source + bounds[1], source + bounds[1], source + n, target);
+                return;
+            }
+
+            size_t merged = 0;
+            for(size_t r = 0; r < runs; r += 2) {
+                if (r + 1 < runs) {
+                    merge_pair<false>(source + bounds[r], source + bounds[r + 1],
+                               source + bounds[r + 1], source + bounds[r + 2], target + bounds[r]);
+                } else {
+                    std::copy(source + bounds[r], source + bounds[r + 1], target + bounds[r]);
+                }
+                bounds[merged++] = bounds[r];
+            }
+
+            bounds[merged] = n;
+            runs = merged;
+            std::swap(source, target);
         }
     }
 
+    // Precondition: end - begin <= kMaxElements
+    template <bool kStream>
+    static void sort_peeled(value_type* begin, value_type* end) {
+        constexpr size_t kAlignment = sizeof(simd_type);
+
+        const auto address = reinterpret_cast<std::uintptr_t>(begin);
+        const size_t head = (address % kAlignment) / sizeof(value_type);
+        const size_t regs = (head + (end - begin) + SimdOps::kPacking - 1) / SimdOps::kPacking;
+        const size_t tail = (head + (end - begin)) % SimdOps::kPacking;
+
+        // a single register masked on both sides cannot be peeled; neither can ranges
+        // whose alignment pushes them beyond the largest network
+        if (regs > kMaxRegisters || (regs == 1 && (head || tail))) {
+            sort<false, false>(begin, end);
+            return;
+        }
+
+        auto packed_it = reinterpret_cast<simd_type*>(address - head * sizeof(value_type));
+        dispatch(regs, [&] (auto k) {
+            peel_sort_store<decltype(k)::index, kStream>(packed_it, head, tail);
+        });
+    }
+
 private:
+    // registers per block of merge_pair
+    constexpr static size_t kMergeRegisters = 4;
+
+    // Merges [a, a_end) and [b, b_end) into out. The registers carried between steps hold
+    // the largest kMergeRegisters registers merged so far; the next block is loaded reversed
+    // from the run with the smaller head, so that both form a bitonic sequence, and the lower
+    // half of its merge is stored. Remainders shorter than a block are merged by scalar code.
+    // Streaming stores need an aligned out, so the leading elements are merged by scalar code.
+    template <bool kStream>
+    static void merge_pair(const value_type* a, const value_type* a_end,
+                           const value_type* b, const value_type* b_end, value_type* out) {
+        constexpr size_t kBlock = kMergeRegisters * SimdOps::kPacking;
+        auto less = [] (value_type x, value_type y) {return Order::less(x, y);};
+
+        if constexpr (kStream) {
+            while (reinterpret_cast<std::uintptr_t>(out) % sizeof(simd_type) && a != a_end && b != b_end)
+                *out++ = less(*b, *a) ? *b++ : *a++;
+        }
+
+        if (static_cast<size_t>(a_end - a) < kBlock || static_cast<size_t>(b_end - b) < kBlock) {
+            std::merge(a, a_end, b, b_end, out, less);
+            return;
+        }
+
+        simd_type registers[2 * kMergeRegisters];
+        load<kMergeRegisters, false, false>(reinterpret_cast<const simd_type*>(a), registers);
+        a += kBlock;
+
+        while (true) {
+            const bool take_b = a == a_end || (b != b_end && less(*b, *a));
+            const value_type*& it = take_b ? b : a;
+            if (static_cast<size_t>((take_b ? b_end : a_end) - it) < kBlock) break;
+
+            load_reversed(reinterpret_cast<const simd_type*>(it), registers + kMergeRegisters);
+            it += kBlock;
+
+            Sorter<2 * kMergeRegisters, Order::kAscending>::merge(registers);
+
+            store<kMergeRegisters, kStream, kStream>(reinterpret_cast<simd_type*>(out), registers);
+            out += kBlock;
+
+            tlx::call_for_range<0, kMergeRegisters>([&] (size_t idx) {
+                registers[idx] = registers[idx + kMergeRegisters];
+            });
+        }
+
+        // at least one run is shorter than a block; it is merged with the carried elements first
+        alignas(simd_type) value_type carried[kBlock];
+        store<kMergeRegisters, true, false>(reinterpret_cast<simd_type*>(carried), registers);
+
+        if (static_cast<size_t>(a_end - a) >= kBlock) {
+            std::swap(a, b);
+            std::swap(a_end, b_end);
+        }
+
+        value_type buffer[2 * kBlock];
+        auto buffer_end = std::merge(carried, carried + kBlock, a, a_end, buffer, less);
+        std::merge(buffer, buffer_end, b, b_end, out, less);
+    }
+
+    static void load_reversed(const simd_type* it, simd_type* x) {
+        tlx::call_for_range<0, kMergeRegisters>([&] (size_t idx) {
+            x[kMergeRegisters - 1 - idx] = SimdOps::mirror(encode(SimdOps::template load<false, false>(it + idx)));
+        });
+    }
+
+    template <typename Functor>
+    static void dispatch(size_t regs, Functor&& f) {
+        tlx::call_for_range<1, kMaxRegisters + 1>([&] (auto k) {
+            if (k == regs) f(k);
+        });
+    }
+
+    // head: number of leading lanes of the first register that are not part of the range
+    // tail: number of lanes of the last register that are part of the range (0 if all are)
+    template <size_t k, bool kStream>
+    static void peel_sort_store(simd_type* packed_it, size_t head, size_t tail) {
+        simd_type registers[k];
+
+        if (head) {
+            registers[0] = encode(SimdOps::partial_load_high(packed_it, head,
+                                                             Order::template first_value<value_type>()));
+        } else {
+            registers[0] = encode(SimdOps::template load<true, kStream>(packed_it));
+        }
+
+        if constexpr (k > 1) {
+            load<k - 2, true, kStream>(packed_it + 1, registers + 1);
+
+            if (tail) {
+                registers[k-1] = encode(SimdOps::partial_load(packed_it + (k-1), tail,
+                                                              Order::template last_value<value_type>()));
+            } else {
+                registers[k-1] = encode(SimdOps::template load<true, kStream>(packed_it + (k-1)));
+            }
+        }
+
+        // the head's padding sorts to the front and the tail's to the back, so every
+        // element ends up in a lane that belongs to the range
+        Sorter<k, Order::kAscending>::sort(registers);
+
+        if (head) {
+            SimdOps::partial_store_high(packed_it, head, encode(registers[0]));
+        } else {
+            SimdOps::template store<true, kStream>(packed_it, encode(registers[0]));
+        }
+
+        if constexpr (k > 1) {
+            store<k - 2, true, kStream>(packed_it + 1, registers + 1);
+
+            if (tail) {
+                SimdOps::partial_store(packed_it + (k-1), tail, encode(registers[k-1]));
+            } else {
+                SimdOps::template store<true, kStream>(packed_it + (k-1), encode(registers[k-1]));
+            }
+        }
+    }
+
+    // Returns the end of the maximal monotone run starting at i; runs opposing Order are reversed
+    static size_t find_run(value_type* data, size_t i, size_t n) {
+        constexpr size_t kPacking = SimdOps::kPacking;
+
+        if (i + 1 == n) return n;
+
+        const bool descending = Order::less(data[i + 1], data[i]);
+        const bool native_descending = descending == Order::kAscending; // w.r.t. the keys' native order
+        size_t j = i; // data[i..j] is monotone
+
+        while (j + kPacking < n) {
+            auto v = encode(SimdOps::template load<false, false>(reinterpret_cast<const simd_type*>(data + j)));
+            auto w = encode(SimdOps::template load<false, false>(reinterpret_cast<const simd_type*>(data + j + 1)));
+
+            if (!SimdOps::equal(v, native_descending ? SimdOps::max(v, w) : SimdOps::min(v, w)))
+                break;
+
+            j += kPacking;
+        }
+
+        if (descending) {
+            while (j + 1 < n && !Order::less(data[j], data[j + 1])) j++;
+            reverse(data + i, data + j + 1);
+        } else {
+            while (j + 1 < n && !Order::less(data[j + 1], data[j])) j++;
+        }
+
+        return j + 1;
+    }
+
+    static void reverse(value_type* begin, value_type* end) {
+        constexpr size_t kPacking = SimdOps::kPacking;
+
+        for(; end - begin >= static_cast<ptrdiff_t>(2 * kPacking); begin += kPacking, end -= kPacking) {
+            auto low_it = reinterpret_cast<simd_type*>(begin);
+            auto high_it = reinterpret_cast<simd_type*>(end - kPacking);
+
+            auto low = SimdOps::template load<false, false>(low_it);
+            auto high = SimdOps::template load<false, false>(high_it);
+
+            SimdOps::template store<false, false>(low_it, SimdOps::mirror(high));
+            SimdOps::template store<false, false>(high_it, SimdOps::mirror(low));
+        }
+
+        std::reverse(begin, end);
+    }
+
+    // maps values to keys and back since key transforms are involutions
+    static simd_type encode(simd_type x) {
+        return Order::Key::template apply<SimdOps>(x);
+    }
+
     template <size_t kSize, bool kAligned, bool kStream>
     static void load(const simd_type* it, simd_type* x) {
         tlx::call_for_range<0, kSize>([&] (size_t idx) {
-            x[idx] = SimdOps::template load<kAligned, kStream>(it + idx);
+            x[idx] = encode(SimdOps::template load<kAligned, kStream>(it + idx));
         });
     }
 
     template <size_t kSize, bool kAligned, bool kStream>
     static void store(simd_type* it, simd_type* x) {
         tlx::call_for_range<0, kSize>([&] (size_t idx) {
-            SimdOps::template store<kAligned, kStream>(it + idx, x[idx]);
+            SimdOps::template store<kAligned, kStream>(it + idx, encode(x[idx]));
         });
     }
 
@@ -110,18 +500,20 @@ private:
             constexpr int kSwitch = kAscending ? 0 : 0xff;
 
             if constexpr (SimdOps::kPacking == 4) {
+                constexpr int kSwitch4 = kSwitch & 0x0f;
+
                 {
                     auto tmp = SimdOps::swap_low_high(v);
                     auto mi = SimdOps::min(v, tmp);
                     auto ma = SimdOps::max(v, tmp);
-                    v = SimdOps::template blend<0xf0 ^ kSwitch>(mi, ma);
+                    v = SimdOps::template blend<0x0c ^ kSwitch4>(mi, ma);
                 }
 
                 {
-                    auto tmp = SimdOps::template shuffle<1, 0>(v);
+                    auto tmp = SimdOps::template shuffle<0, 1>(v);
                     auto mi = SimdOps::min(v, tmp);
                     auto ma = SimdOps::max(v, tmp);
-                    v = SimdOps::template blend<0x11 ^ kSwitch>(mi, ma);
+                    v = SimdOps::template blend<0x0a ^ kSwitch4>(mi, ma);
                 }
             } else if constexpr (SimdOps::kPacking == 8) {
                 {
@@ -176,7 +568,7 @@ private:
                     auto tmp = SimdOps::template shuffle<0, 1>(v);
                     auto mi = SimdOps::min(v, tmp);
                     auto ma = SimdOps::max(v, tmp);
-                    v = SimdOps::template blend<0x12>(mi, ma);
+                    v = SimdOps::template blend<0x06>(mi, ma);
                 }
             } else if constexpr (SimdOps::kPacking == 8) {
                 {
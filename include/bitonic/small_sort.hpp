@@ -0,0 +1,329 @@
+#pragma once
+
+#include "simd/simd_sort.hpp"
+#include "call_for_range.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace Bitonic {
+
+namespace small_sort_detail {
+
+struct Comparator {
+    uint8_t first;
+    uint8_t second;
+};
+
+// Batcher's odd-even merge sort restricted to n inputs
+constexpr size_t batcher_size(size_t n, Comparator* out = nullptr) {
+    size_t size = 0;
+    for(size_t p = 1; p < n; p *= 2) {
+        for(size_t k = p; k >= 1; k /= 2) {
+            for(size_t j = k % p; j + k < n; j += 2 * k) {
+                for(size_t i = 0; i < k && i + j + k < n; i++) {
+                    if ((i + j) / (2 * p) == (i + j + k) / (2 * p)) {
+                        if (out) out[size] = {static_cast<uint8_t>(i + j), static_cast<uint8_t>(i + j + k)};
+                        size++;
+                    }
+                }
+            }
+        }
+    }
+    return size;
+}
+
+template <size_t N>
+constexpr std::array<Comparator, batcher_size(N)> batcher() {
+    std::array<Comparator, batcher_size(N)> network{};
+    batcher_size(N, network.data());
+    return network;
+}
+
+// Networks up to 9 inputs are depth-optimal and those for 10 to 12 inputs use the fewest known
+// comparators. 13 to 20 inputs use Batcher's networks, which need a few comparators more than
+// the best known ones (48 instead of 45 for 13 inputs, 103 instead of 91 for 20).
+template <size_t N>
+struct Network {
+    constexpr static auto kComparators = batcher<N>();
+};
+
+template <>
+struct Network<2> {
+    constexpr static std::array<Comparator, 1> kComparators {{
+        {0,1}
+    }};
+};
+
+template <>
+struct Network<3> {
+    constexpr static std::array<Comparator, 3> kComparators {{
+        {0,2}, {0,1}, {1,2}
+    }};
+};
+
+template <>
+struct Network<4> {
+    constexpr static std::array<Comparator, 5> kComparators {{
+        {0,2}, {1,3},
+        {0,1}, {2,3},
+        {1,2}
+    }};
+};
+
+template <>
+struct Network<5> {
+    constexpr static std::array<Comparator, 9> kComparators {{
+        {0,3}, {1,4},
+        {0,2}, {1,3},
+        {0,1}, {2,4},
+        {1,2}, {3,4},
+        {2,3}
+    }};
+};
+
+template <>
+struct Network<6> {
+    constexpr static std::array<Comparator, 12> kComparators {{
+        {0,5}, {1,3}, {2,4},
+        {1,2}, {3,4},
+        {0,3}, {2,5},
+        {0,1}, {2,3}, {4,5},
+        {1,2}, {3,4}
+    }};
+};
+
+template <>
+struct Network<7> {
+    constexpr static std::array<Comparator, 16> kComparators {{
+        {0,6}, {2,3}, {4,5},
+        {0,2}, {1,4}, {3,6},
+        {0,1}, {2,5}, {3,4},
+        {1,2}, {4,6},
+        {2,3}, {4,5},
+        {1,2}, {3,4}, {5,6}
+    }};
+};
+
+template <>
+struct Network<8> {
+    constexpr static std::array<Comparator, 19> kComparators {{
+        {0,2}, {1,3}, {4,6}, {5,7},
+        {0,4}, {1,5}, {2,6}, {3,7},
+        {0,1}, {2,3}, {4,5}, {6,7},
+        {2,4}, {3,5},
+        {1,4}, {3,6},
+        {1,2}, {3,4}, {5,6}
+    }};
+};
+
+template <>
+struct Network<9> {
+    constexpr static std::array<Comparator, 25> kComparators {{
+        {0,3}, {1,7}, {2,5}, {4,8},
+        {0,7}, {2,4}, {3,8}, {5,6},
+        {0,2}, {1,3}, {4,5}, {7,8},
+        {1,4}, {3,6}, {5,7},
+        {0,1}, {2,4}, {3,5}, {6,8},
+        {2,3}, {4,5}, {6,7},
+        {1,2}, {3,4}, {5,6}
+    }};
+};
+
+template <>
+struct Network<10> {
+    constexpr static std::array<Comparator, 29> kComparators {{
+        {0,8}, {1,9}, {2,7}, {3,5}, {4,6},
+        {0,2}, {1,4}, {5,8}, {7,9},
+        {0,3}, {2,4}, {5,7}, {6,9},
+        {0,1}, {3,6}, {8,9},
+        {1,5}, {2,3}, {4,8}, {6,7},
+        {1,2}, {3,5}, {4,6}, {7,8},
+        {2,3}, {4,5}, {6,7},
+        {3,4}, {5,6}
+    }};
+};
+
+// the 12-input network without the comparators touching input 11
+template <>
+struct Network<11> {
+    constexpr static std::array<Comparator, 35> kComparators {{
+        {0,8}, {1,7}, {2,6}, {4,10}, {5,9},
+        {0,1}, {2,5}, {3,4}, {6,9}, {7,8},
+        {0,2}, {1,6}, {5,10},
+        {0,3}, {1,2}, {4,6}, {5,7}, {9,10},
+        {1,4}, {3,5}, {6,8}, {7,10},
+        {1,3}, {2,5}, {6,9}, {8,10},
+        {2,3}, {4,5}, {6,7}, {8,9},
+        {4,6}, {5,7},
+        {3,4}, {5,6}, {7,8}
+    }};
+};
+
+template <>
+struct Network<12> {
+    constexpr static std::array<Comparator, 39> kComparators {{
+        {0,8}, {1,7}, {2,6}, {3,11}, {4,10}, {5,9},
+        {0,1}, {2,5}, {3,4}, {6,9}, {7,8}, {10,11},
+        {0,2}, {1,6}, {5,10}, {9,11},
+        {0,3}, {1,2}, {4,6}, {5,7}, {8,11}, {9,10},
+        {1,4}, {3,5}, {6,8}, {7,10},
+        {1,3}, {2,5}, {6,9}, {8,10},
+        {2,3}, {4,5}, {6,7}, {8,9},
+        {4,6}, {5,7},
+        {3,4}, {5,6}, {7,8}
+    }};
+};
+
+} // namespace small_sort_detail
+
+// Sorts many short arrays at once. kPacking arrays are transposed such that register r
+// holds the r-th element of every array, and a size-specialized comparator network then
+// sorts all of them with one min/max pair per comparator and without any padding.
+// Adapters have to provide transpose() for a kPacking x kPacking tile of registers.
+template <typename SimdOps_>
+class SmallSort {
+    using SimdOps = SimdOps_;
+    using value_type = typename SimdOps::value_type;
+    using simd_type  = typename SimdOps::simd_type;
+
+public:
+    // Arrays longer than this are sorted one after another by SimdSort
+    constexpr static size_t kMaxLength = 20;
+
+    // Sorts the count arrays [data + i*length, data + (i+1)*length) individually; the context
+    // is only needed for arrays beyond SimdSort's kMaxElements
+    static void sort_many(value_type* data, size_t length, size_t count, SortContext& context) {
+        if (length < 2) return;
+
+        if (length > kMaxLength) {
+            for(size_t i = 0; i != count; i++)
+                SimdSort<SimdOps>::sort_range(data + i * length, data + (i + 1) * length, context);
+            return;
+        }
+
+        tlx::call_for_range<2, kMaxLength + 1>([&] (auto n) {
+            if (n == length) sort_many<decltype(n)::index>(data, count);
+        });
+    }
+
+    // uses a temporary context, which allocates only for arrays beyond kMaxElements
+    static void sort_many(value_type* data, size_t length, size_t count) {
+        SortContext context;
+        sort_many(data, length, count, context);
+    }
+
+    template <size_t N>
+    static void sort_many(value_type* data, size_t count) {
+        constexpr size_t kPacking = SimdOps::kPacking;
+
+        for(; count >= kPacking; count -= kPacking, data += N * kPacking)
+            transpose_sort<N>(data);
+
+        if (count)
+            gather_sort<N>(data, count);
+    }
+
+private:
+    // Sorts kPacking consecutive arrays. Each tile of kPacking columns is loaded as one row
+    // per array and transposed in registers by the adapter. Rows of the last tile may reach
+    // into the following arrays; as all loads precede the stores, the last tile is stored
+    // first and rows in order, the overlap is rewritten with the right values. Rows reaching
+    // beyond the kPacking arrays are masked.
+    template <size_t N>
+    static void transpose_sort(value_type* data) {
+        constexpr size_t kPacking = SimdOps::kPacking;
+        constexpr size_t kTiles = (N + kPacking - 1) / kPacking;
+
+        simd_type registers[kTiles * kPacking];
+
+        tlx::call_for_range<0, kTiles>([&] (auto tile) {
+            constexpr size_t kTile = decltype(tile)::index;
+            simd_type* rows = registers + kTile * kPacking;
+
+            tlx::call_for_range<0, kPacking>([&] (auto row) {
+                constexpr size_t kRow = decltype(row)::index;
+                constexpr size_t kAvailable = kPacking * N - (kRow * N + kTile * kPacking);
+                auto it = reinterpret_cast<const simd_type*>(data + kRow * N + kTile * kPacking);
+
+                if constexpr (kAvailable < kPacking) {
+                    rows[kRow] = SimdOps::partial_load(it, kAvailable, value_type(0));
+                } else {
+                    rows[kRow] = SimdOps::template load<false, false>(it);
+                }
+            });
+
+            SimdOps::transpose(rows);
+        });
+
+        sort_registers<N>(registers);
+
+        tlx::call_for_range<0, kTiles>([&] (auto tile) {
+            constexpr size_t kTile = kTiles - 1 - decltype(tile)::index;
+            simd_type* rows = registers + kTile * kPacking;
+
+            SimdOps::transpose(rows);
+
+            tlx::call_for_range<0, kPacking>([&] (auto row) {
+                constexpr size_t kRow = decltype(row)::index;
+                constexpr size_t kAvailable = kPacking * N - (kRow * N + kTile * kPacking);
+                auto it = reinterpret_cast<simd_type*>(data + kRow * N + kTile * kPacking);
+
+                if constexpr (kAvailable < kPacking) {
+                    SimdOps::partial_store(it, kAvailable, rows[kRow]);
+                } else {
+                    SimdOps::template store<false, false>(it, rows[kRow]);
+                }
+            });
+        });
+    }
+
+    // Sorts fewer than kPacking arrays, padding the missing lanes
+    template <size_t N>
+    static void gather_sort(value_type* data, size_t arrays) {
+        constexpr size_t kPacking = SimdOps::kPacking;
+
+        alignas(simd_type) value_type lanes[N * kPacking];
+        simd_type registers[N];
+
+        for(size_t j = 0; j != arrays; j++)
+            for(size_t r = 0; r != N; r++)
+                lanes[r * kPacking + j] = data[j * N + r];
+
+        for(size_t j = arrays; j != kPacking; j++)
+            for(size_t r = 0; r != N; r++)
+                lanes[r * kPacking + j] = std::numeric_limits<value_type>::max();
+
+        auto packed_it = reinterpret_cast<simd_type*>(lanes);
+        tlx::call_for_range<0, N>([&] (size_t r) {
+            registers[r] = SimdOps::template load<true, false>(packed_it + r);
+        });
+
+        sort_registers<N>(registers);
+
+        tlx::call_for_range<0, N>([&] (size_t r) {
+            SimdOps::template store<true, false>(packed_it + r, registers[r]);
+        });
+
+        for(size_t j = 0; j != arrays; j++)
+            for(size_t r = 0; r != N; r++)
+                data[j * N + r] = lanes[r * kPacking + j];
+    }
+
+    template <size_t N>
+    static void sort_registers(simd_type* v) {
+        using Network = small_sort_detail::Network<N>;
+
+        tlx::call_for_range<0, Network::kComparators.size()>([&] (auto i) {
+            constexpr auto comparator = Network::kComparators[decltype(i)::index];
+            auto mi = SimdOps::min(v[comparator.first], v[comparator.second]);
+            auto ma = SimdOps::max(v[comparator.first], v[comparator.second]);
+            v[comparator.first] = mi;
+            v[comparator.second] = ma;
+        });
+    }
+};
+
+}
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <utility>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+namespace Bitonic {
+
+// Owns the scratch memory of sorts that need more than their input range. Each slot
+// grows to the largest job seen and is kept until release(), so repeated sorts of
+// similar sizes neither allocate nor fault in fresh pages.
+class SortContext {
+public:
+    constexpr static size_t kAlignment = 64;
+    constexpr static size_t kHugePageSize = 2 << 20;
+
+    constexpr static size_t kMergeSlot   = 0; // elements of the range being merged
+    constexpr static size_t kRunSlot     = 1; // boundaries of sorted runs
+    constexpr static size_t kKeySlot     = 2; // keys derived from the input, e.g. by StringSort
+    constexpr static size_t kSegmentSlot = 3; // stack of unsorted segments of IncrementalSort
+    constexpr static size_t kNumSlots    = 4;
+
+    explicit SortContext(bool huge_pages = false) : huge_pages_(huge_pages) {}
+
+    SortContext(const SortContext&) = delete;
+    SortContext& operator=(const SortContext&) = delete;
+
+    SortContext(SortContext&& other) noexcept
+        : huge_pages_(other.huge_pages_), allocations_(other.allocations_) {
+        for(size_t i = 0; i != kNumSlots; i++)
+            std::swap(slots_[i], other.slots_[i]);
+    }
+
+    SortContext& operator=(SortContext&& other) noexcept {
+        if (this != &other) {
+            release();
+            huge_pages_ = other.huge_pages_;
+            allocations_ = other.allocations_;
+            for(size_t i = 0; i != kNumSlots; i++)
+                std::swap(slots_[i], other.slots_[i]);
+        }
+        return *this;
+    }
+
+    ~SortContext() {
+        release();
+    }
+
+    // Returns kAlignment-aligned storage for at least n objects of type T
+    template <typename T>
+    T* scratch(size_t slot, size_t n) {
+        return reinterpret_cast<T*>(reserve(slot, n * sizeof(T)));
+    }
+
+    void* reserve(size_t slot, size_t bytes) {
+        auto& buffer = slots_[slot];
+        if (bytes > buffer.size) {
+            deallocate(buffer);
+            allocate(buffer, bytes);
+        }
+        return buffer.data;
+    }
+
+    // Like reserve(), but keeps the contents of the slot; the capacity at least doubles
+    void* grow(size_t slot, size_t bytes) {
+        auto& buffer = slots_[slot];
+        if (bytes > buffer.size) {
+            Buffer old = buffer;
+            allocate(buffer, std::max(bytes, 2 * old.size));
+            if (old.data) std::memcpy(buffer.data, old.data, old.size);
+            deallocate(old);
+        }
+        return buffer.data;
+    }
+
+    void release() {
+        for(auto& buffer : slots_)
+            deallocate(buffer);
+    }
+
+    size_t capacity(size_t slot) const {return slots_[slot].size;}
+
+    // number of allocations carried out since construction
+    size_t allocations() const {return allocations_;}
+
+    bool huge_pages() const {return huge_pages_;}
+
+private:
+    struct Buffer {
+        void*  data = nullptr;
+        size_t size = 0;
+        bool   mapped = false;
+    };
+
+    bool huge_pages_;
+    size_t allocations_ = 0;
+    Buffer slots_[kNumSlots];
+
+    static size_t round_up(size_t x, size_t multiple) {
+        return (x + multiple - 1) / multiple * multiple;
+    }
+
+    void allocate(Buffer& buffer, size_t bytes) {
+        allocations_++;
+
+#ifdef __linux__
+        if (huge_pages_) {
+            // mmap only guarantees page alignment, so map one huge page more than needed
+            // and trim the region to a kHugePageSize-aligned start
+            const size_t size = round_up(bytes, kHugePageSize);
+            void* ptr = mmap(nullptr, size + kHugePageSize, PROT_READ | PROT_WRITE,
+                             MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (ptr != MAP_FAILED) {
+                auto* raw = static_cast<char*>(ptr);
+                auto* aligned = reinterpret_cast<char*>(
+                    round_up(reinterpret_cast<uintptr_t>(raw), kHugePageSize));
+                const size_t head = static_cast<size_t>(aligned - raw);
+                if (head) munmap(raw, head);
+                if (head != kHugePageSize) munmap(aligned + size, kHugePageSize - head);
+
+                madvise(aligned, size, MADV_HUGEPAGE); // only a hint; regular pages work as well
+                buffer = {aligned, size, true};
+                return;
+            }
+        }
+#endif
+
+        const size_t size = round_up(bytes, kAlignment);
+        void* ptr = std::aligned_alloc(kAlignment, size);
+        if (!ptr) throw std::bad_alloc();
+        buffer = {ptr, size, false};
+    }
+
+    static void deallocate(Buffer& buffer) {
+        if (!buffer.data) return;
+
+#ifdef __linux__
+        if (buffer.mapped) {
+            munmap(buffer.data, buffer.size);
+            buffer = {};
+            return;
+        }
+#endif
+
+        std::free(buffer.data);
+        buffer = {};
+    }
+};
+
+}
@@ -0,0 +1,147 @@
+#pragma once
+
+#include "simd/simd_sort.hpp"
+#include "simd/int64.hpp"
+#include "sort_context.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string_view>
+#include <utility>
+
+namespace Bitonic {
+
+// Sorts string keys by their leading bytes using the integer networks. Each key is
+// represented by a 64-bit integer holding a big-endian 4-byte chunk of the string in
+// its upper and the key's position in its lower half. Runs sharing a chunk are refined
+// with the next chunk; strings exhausted within a run precede the others ordered by
+// length, and small runs fall back to comparing the remaining suffixes. Ties are
+// broken by position, so the sort is stable.
+//
+// The range must contain fewer than 2^32 elements, each convertible to std::string_view.
+class StringSort {
+    using SimdOps = SimdAdapter::UnsignedInt64;
+    using Sort = SimdSort<SimdOps>;
+
+public:
+    constexpr static size_t kChunkSize = 4;
+    constexpr static size_t kFallbackThreshold = 16;
+
+    template <typename Iterator>
+    static void sort(Iterator begin, Iterator end, SortContext& context) {
+        const auto n = static_cast<size_t>(std::distance(begin, end));
+        if (n < 2) return;
+
+        auto keys = context.scratch<uint64_t>(SortContext::kKeySlot, n);
+        for(size_t i = 0; i != n; i++)
+            keys[i] = make_key(view(begin[i]), 0, i);
+
+        sort_keys(begin, keys, keys + n, 0, context);
+
+        permute(begin, keys, n);
+    }
+
+    template <typename Container>
+    static void sort(Container& container, SortContext& context) {
+        sort(std::begin(container), std::end(container), context);
+    }
+
+private:
+    constexpr static uint64_t kIndexMask = 0xffffffffull;
+
+    template <typename T>
+    static std::string_view view(const T& x) {
+        return std::string_view(x);
+    }
+
+    static uint64_t make_key(std::string_view str, size_t depth, uint64_t index) {
+        uint64_t chunk = 0;
+        for(size_t i = 0; i != kChunkSize; i++) {
+            const size_t pos = depth + i;
+            const uint8_t byte = pos < str.size() ? static_cast<uint8_t>(str[pos]) : 0;
+            chunk = (chunk << 8) | byte;
+        }
+
+        return (chunk << 32) | index;
+    }
+
+    template <typename Iterator>
+    static void sort_keys(Iterator strings, uint64_t* begin, uint64_t* end, size_t depth, SortContext& context) {
+        Sort::sort_range(begin, end, context);
+
+        for(auto run_begin = begin; run_begin != end; ) {
+            const uint64_t chunk = *run_begin >> 32;
+
+            auto run_end = run_begin + 1;
+            while (run_end != end && (*run_end >> 32) == chunk)
+                run_end++;
+
+            if (run_end - run_begin > 1)
+                refine(strings, run_begin, run_end, depth, context);
+
+            run_begin = run_end;
+        }
+    }
+
+    // Sorts a run of keys that agree on the chunk at depth
+    template <typename Iterator>
+    static void refine(Iterator strings, uint64_t* begin, uint64_t* end, size_t depth, SortContext& context) {
+        const size_t next_depth = depth + kChunkSize;
+        auto size = [&] (uint64_t key) {return view(strings[key & kIndexMask]).size();};
+
+        // An exhausted string is a prefix of every longer string of the run, since the
+        // chunk padded it with zero bytes that the others contain as well
+        auto exhausted_end = std::partition(begin, end, [&] (uint64_t key) {
+            return size(key) <= next_depth;
+        });
+
+        std::sort(begin, exhausted_end, [&] (uint64_t a, uint64_t b) {
+            return std::make_pair(size(a), a & kIndexMask) < std::make_pair(size(b), b & kIndexMask);
+        });
+
+        begin = exhausted_end;
+        if (end - begin < 2) return;
+
+        if (static_cast<size_t>(end - begin) <= kFallbackThreshold) {
+            std::sort(begin, end, [&] (uint64_t a, uint64_t b) {
+                const auto sa = view(strings[a & kIndexMask]).substr(depth);
+                const auto sb = view(strings[b & kIndexMask]).substr(depth);
+                const int cmp = sa.compare(sb);
+                return cmp < 0 || (cmp == 0 && (a & kIndexMask) < (b & kIndexMask));
+            });
+            return;
+        }
+
+        for(auto it = begin; it != end; it++)
+            *it = make_key(view(strings[*it & kIndexMask]), next_depth, *it & kIndexMask);
+
+        sort_keys(strings, begin, end, next_depth, context);
+    }
+
+    // Moves strings[keys[i]] to position i by following cycles; keys are used as markers
+    template <typename Iterator>
+    static void permute(Iterator strings, uint64_t* keys, size_t n) {
+        for(size_t i = 0; i != n; i++) {
+            if ((keys[i] & kIndexMask) == i) continue;
+
+            auto tmp = std::move(strings[i]);
+            size_t j = i;
+            while (true) {
+                const size_t source = keys[j] & kIndexMask;
+                keys[j] = j;
+
+                if (source == i) {
+                    strings[j] = std::move(tmp);
+                    break;
+                }
+
+                strings[j] = std::move(strings[source]);
+                j = source;
+            }
+        }
+    }
+};
+
+}
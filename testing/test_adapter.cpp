@@ -1,6 +1,7 @@
 #include <bitonic/simd.hpp>
 #include "helper.hpp"
 
+#include <algorithm>
 #include <memory>
 #include <iostream>
 #include <random>
@@ -104,6 +105,32 @@ static void test_all() {
         }
     }
 
+    std::cout << " partial_load_high&partial_store_high\n";
+    {
+        for(int i=0; i != 1000; i++) {
+            random_fill(data, 2*kPacking);
+
+            const size_t offset = i % kPacking;
+            auto reg = SimdOps::partial_load_high(regs, offset, 123);
+            SimdOps::template store<true, false>(regs + 1, reg);
+
+            for(size_t j=0; j != offset; j++)
+                die_unless_equal(data[kPacking + j], 123, j);
+            for(size_t j=offset; j != kPacking; j++)
+                die_unless_equal(data[kPacking + j], data[j], j);
+
+            for(size_t j=0; j != kPacking; j++)
+                data[kPacking + j] = 0xde * j;
+
+            SimdOps::partial_store_high(regs + 1, offset, reg);
+
+            for(size_t j=0; j != offset; j++)
+                die_unless_equal(data[kPacking + j], 0xde * j, j);
+            for(size_t j=offset; j != kPacking; j++)
+                die_unless_equal(data[kPacking + j], data[j], j);
+        }
+    }
+
     std::cout << " swap_low_high\n";
     {
         for(int i=0; i != 100; i++) {
@@ -138,6 +165,22 @@ static void test_all() {
         }
     }
 
+    std::cout << " equal\n";
+    {
+        for(int i=0; i != 100; i++) {
+            random_fill(data, kPacking);
+            std::copy(data, data + kPacking, data + kPacking);
+
+            const size_t lane = i % (kPacking + 1);
+            if (lane < kPacking) data[kPacking + lane]++;
+
+            auto a = SimdOps::template load<true, false>(regs);
+            auto b = SimdOps::template load<true, false>(regs + 1);
+
+            die_unless_equal(SimdOps::equal(a, b), lane == kPacking, lane);
+        }
+    }
+
     std::cout << " min/max\n";
     {
         for(int i=0; i != 100; i++) {
@@ -164,16 +207,37 @@ static void test_all() {
         }
     }
 
+    std::cout << " transpose\n";
+    {
+        random_fill(data, 2 * kPacking * kPacking);
+
+        simd_type tile[kPacking];
+        for(size_t r = 0; r != kPacking; r++)
+            tile[r] = SimdOps::template load<true, false>(regs + r);
+
+        SimdOps::transpose(tile);
+
+        for(size_t r = 0; r != kPacking; r++)
+            SimdOps::template store<true, false>(regs + kPacking + r, tile[r]);
+
+        for(size_t r = 0; r != kPacking; r++)
+            for(size_t c = 0; c != kPacking; c++)
+                die_unless_equal(data[kPacking * kPacking + r * kPacking + c], data[c * kPacking + r], r, c);
+    }
+
 
 }
 
 
 int main() {
-    test_all<Bitonic::SimdAdapter::SignedInt16>();
-    test_all<Bitonic::SimdAdapter::UnsignedInt16>();
-
     test_all<Bitonic::SimdAdapter::SignedInt32>();
     test_all<Bitonic::SimdAdapter::UnsignedInt32>();
 
+    test_all<Bitonic::SimdAdapter::SignedInt32x4>();
+    test_all<Bitonic::SimdAdapter::UnsignedInt32x4>();
+
+    test_all<Bitonic::SimdAdapter::SignedInt64>();
+    test_all<Bitonic::SimdAdapter::UnsignedInt64>();
+
     return 0;
 }
@@ -0,0 +1,69 @@
+#include <bitonic/simd/simd_sort.hpp>
+#include <bitonic/simd/int32.hpp>
+#include <bitonic/simd/int64.hpp>
+#include "helper.hpp"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+std::mt19937_64 prng{5};
+
+template <typename SimdOps>
+void test_pattern(const char* name, std::vector<typename SimdOps::value_type> data, bool presorted = false) {
+    using Sort = Bitonic::SimdSort<SimdOps>;
+
+    std::cout << "test_pattern          <" << name << ", " << data.size() << ", " << SimdOps::name() << ">\n";
+
+    auto ref = data;
+    std::sort(ref.begin(), ref.end());
+
+    Bitonic::SortContext context;
+    Sort::sort_adaptive(data, context);
+
+    die_unless(data == ref, name);
+
+    if (presorted)
+        die_unless_equal(context.capacity(Bitonic::SortContext::kMergeSlot), size_t(0), "Presorted input must not be merged");
+}
+
+template <typename SimdOps>
+void test_all_patterns() {
+    using value_type = typename SimdOps::value_type;
+    std::uniform_int_distribution<value_type> distr;
+
+    for(size_t N : {0, 1, 2, 9, 255, 256, 257, 1000, 100000}) {
+        std::vector<value_type> data(N);
+
+        std::generate(data.begin(), data.end(), [&] { return distr(prng); });
+        test_pattern<SimdOps>("random", data);
+
+        std::sort(data.begin(), data.end());
+        test_pattern<SimdOps>("ascending", data, true);
+
+        std::reverse(data.begin(), data.end());
+        test_pattern<SimdOps>("descending", data, true);
+
+        std::sort(data.begin(), data.end());
+        for(size_t i = 0; i + 1 < N; i += 37)
+            std::swap(data[i], data[i + 1]);
+        test_pattern<SimdOps>("nearly sorted", data);
+
+        for(size_t i = 0; i != N; i++)
+            data[i] = static_cast<value_type>((i / 1000) % 2 ? 1000 - i % 1000 : i % 1000);
+        test_pattern<SimdOps>("zigzag", data);
+
+        std::sort(data.begin(), data.end());
+        std::fill(data.begin() + N / 2, data.end(), value_type{});
+        test_pattern<SimdOps>("sorted with zero tail", data);
+    }
+}
+
+int main() {
+    test_all_patterns<Bitonic::SimdAdapter::SignedInt32>();
+    test_all_patterns<Bitonic::SimdAdapter::UnsignedInt32>();
+    test_all_patterns<Bitonic::SimdAdapter::SignedInt32x4>();
+    test_all_patterns<Bitonic::SimdAdapter::UnsignedInt64>();
+
+    return 0;
+}
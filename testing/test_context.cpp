@@ -0,0 +1,144 @@
+#include <bitonic/simd/simd_sort.hpp>
+#include <bitonic/simd/int32.hpp>
+#include <bitonic/simd/int64.hpp>
+#include "helper.hpp"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+std::mt19937_64 prng{2};
+
+template <typename SimdOps>
+void test_large(bool huge_pages) {
+    using value_type = typename SimdOps::value_type;
+    using Sort = Bitonic::SimdSort<SimdOps>;
+
+    std::cout << "test_large            <" << SimdOps::name() << ", huge_pages=" << huge_pages << ">\n";
+
+    std::uniform_int_distribution<value_type> distr;
+    Bitonic::SortContext context(huge_pages);
+
+    for(size_t N : {0, 1, 7, 255, 256, 257, 511, 1000, 4096, 10000, 65537, 300000}) {
+        for(size_t offset = 0; offset != SimdOps::kPacking; offset++) {
+            std::vector<value_type> buffer(N + offset + 1);
+            std::generate(buffer.begin(), buffer.end(), [&] { return distr(prng); });
+
+            auto begin = buffer.data() + offset;
+            std::vector<value_type> ref(begin, begin + N);
+            std::sort(ref.begin(), ref.end());
+
+            const auto last_value = buffer.back();
+            Sort::sort_range(begin, begin + N, context);
+
+            die_unless(std::equal(ref.begin(), ref.end(), begin), "N=", N, " offset=", offset);
+            die_unless_equal(buffer.back(), last_value, "Last value");
+        }
+    }
+}
+
+template <typename SimdOps>
+void test_no_reallocation() {
+    using value_type = typename SimdOps::value_type;
+    using Sort = Bitonic::SimdSort<SimdOps>;
+
+    std::cout << "test_no_reallocation  <" << SimdOps::name() << ">\n";
+
+    std::uniform_int_distribution<value_type> distr;
+    Bitonic::SortContext context;
+
+    std::vector<value_type> data(100000);
+    std::generate(data.begin(), data.end(), [&] { return distr(prng); });
+    Sort::sort_range(data, context);
+
+    const auto allocations = context.allocations();
+    die_unless(allocations > 0);
+
+    for(size_t N : {100000, 50000, 1234, 99999}) {
+        std::vector<value_type> data(N);
+        std::generate(data.begin(), data.end(), [&] { return distr(prng); });
+        Sort::sort_range(data, context);
+
+        die_unless(std::is_sorted(data.begin(), data.end()), "N=", N);
+        die_unless_equal(context.allocations(), allocations, "N=", N);
+    }
+}
+
+// the merge kernel selects blocks by their heads, which ties must not confuse
+template <typename SimdOps>
+void test_duplicates() {
+    using value_type = typename SimdOps::value_type;
+    using Sort = Bitonic::SimdSort<SimdOps>;
+
+    std::cout << "test_duplicates       <" << SimdOps::name() << ">\n";
+
+    std::uniform_int_distribution<int> distr{0, 3};
+    Bitonic::SortContext context;
+
+    for(size_t N : {1000, 4099, 100000}) {
+        std::vector<value_type> data(N);
+        std::generate(data.begin(), data.end(), [&] { return static_cast<value_type>(distr(prng)); });
+
+        auto ref = data;
+        std::sort(ref.begin(), ref.end());
+
+        Sort::sort_range(data, context);
+        die_unless(data == ref, "N=", N);
+    }
+}
+
+void test_grow() {
+    std::cout << "test_grow\n";
+
+    Bitonic::SortContext context;
+    auto slot = Bitonic::SortContext::kSegmentSlot;
+
+    auto* data = static_cast<size_t*>(context.reserve(slot, 10 * sizeof(size_t)));
+    for(size_t i = 0; i != 10; i++)
+        data[i] = i;
+
+    data = static_cast<size_t*>(context.grow(slot, 1000 * sizeof(size_t)));
+    die_unless(context.capacity(slot) >= 1000 * sizeof(size_t));
+    for(size_t i = 0; i != 10; i++)
+        die_unless_equal(data[i], i, "Contents must be kept");
+
+    const auto allocations = context.allocations();
+    context.grow(slot, 10 * sizeof(size_t));
+    die_unless_equal(context.allocations(), allocations, "Shrinking must not allocate");
+}
+
+void test_alignment(bool huge_pages) {
+    std::cout << "test_alignment        <huge_pages=" << huge_pages << ">\n";
+
+    Bitonic::SortContext context(huge_pages);
+    for(size_t bytes : {1, 4096, 3 << 20}) {
+        for(size_t slot = 0; slot != Bitonic::SortContext::kNumSlots; slot++) {
+            auto* ptr = static_cast<char*>(context.reserve(slot, bytes));
+            die_unless(is_aligned(ptr, Bitonic::SortContext::kAlignment), "bytes=", bytes);
+#ifdef __linux__
+            if (huge_pages)
+                die_unless(is_aligned(ptr, Bitonic::SortContext::kHugePageSize), "bytes=", bytes);
+#endif
+            std::fill(ptr, ptr + context.capacity(slot), char(slot)); // must be writable
+        }
+    }
+}
+
+int main() {
+    test_large<Bitonic::SimdAdapter::SignedInt32>(false);
+    test_large<Bitonic::SimdAdapter::SignedInt32>(true);
+    test_large<Bitonic::SimdAdapter::UnsignedInt32>(false);
+
+    test_duplicates<Bitonic::SimdAdapter::SignedInt32>();
+    test_duplicates<Bitonic::SimdAdapter::UnsignedInt64>();
+
+    test_grow();
+
+    test_alignment(false);
+    test_alignment(true);
+
+    test_no_reallocation<Bitonic::SimdAdapter::SignedInt32>();
+    test_no_reallocation<Bitonic::SimdAdapter::UnsignedInt32>();
+
+    return 0;
+}
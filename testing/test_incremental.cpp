@@ -0,0 +1,110 @@
+#include <bitonic/incremental_sort.hpp>
+#include <bitonic/simd/int32.hpp>
+#include "helper.hpp"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+std::mt19937_64 prng{3};
+
+template <typename SimdOps>
+void test_blocks(size_t N, typename SimdOps::value_type max_value) {
+    using value_type = typename SimdOps::value_type;
+
+    std::cout << "test_blocks           <" << N << ", " << max_value << ", " << SimdOps::name() << ">\n";
+
+    std::uniform_int_distribution<value_type> distr{0, max_value};
+    std::vector<value_type> data(N);
+    std::generate(data.begin(), data.end(), [&] { return distr(prng); });
+
+    auto ref = data;
+    std::sort(ref.begin(), ref.end());
+
+    Bitonic::SortContext context;
+    Bitonic::IncrementalSort<SimdOps> inc(data, context);
+
+    size_t emitted = 0;
+    while (!inc.done()) {
+        auto block = inc.next();
+        die_unless(block.first == data.data() + emitted, "Blocks must be consecutive");
+        die_unless(block.first != block.second, "Empty block before done()");
+
+        for(auto it = block.first; it != block.second; it++, emitted++)
+            die_unless_equal(*it, ref[emitted], "N=", N, " index=", emitted);
+    }
+
+    die_unless_equal(emitted, N);
+
+    auto block = inc.next();
+    die_unless(block.first == block.second);
+}
+
+template <typename SimdOps>
+void test_prefix() {
+    using value_type = typename SimdOps::value_type;
+
+    std::cout << "test_prefix           <" << SimdOps::name() << ">\n";
+
+    std::uniform_int_distribution<value_type> distr;
+    constexpr size_t N = 100000;
+
+    Bitonic::SortContext context;
+    for(size_t k : {1, 10, 300, 5000}) {
+        std::vector<value_type> data(N);
+        std::generate(data.begin(), data.end(), [&] { return distr(prng); });
+
+        auto ref = data;
+        std::partial_sort(ref.begin(), ref.begin() + k, ref.end());
+
+        Bitonic::IncrementalSort<SimdOps> inc(data, context);
+        auto end = inc.sort_prefix(k);
+
+        die_unless(end >= data.data() + k);
+        die_unless(end < data.data() + N, "Prefix must not sort everything");
+        die_unless(std::equal(ref.begin(), ref.begin() + k, data.begin()), "k=", k);
+    }
+}
+
+// repeated queries on a warm context must not allocate
+template <typename SimdOps>
+void test_no_allocation() {
+    using value_type = typename SimdOps::value_type;
+
+    std::cout << "test_no_allocation    <" << SimdOps::name() << ">\n";
+
+    Bitonic::SortContext context;
+    size_t allocations = 0;
+
+    for(size_t iter = 0; iter != 10; iter++) {
+        std::vector<value_type> data(20000);
+        for(size_t i = 0; i != data.size(); i++)
+            data[i] = static_cast<value_type>(iter % 2 ? i : i * 7919 % data.size());
+
+        Bitonic::IncrementalSort<SimdOps> inc(data, context);
+        inc.sort_prefix(1000);
+        die_unless(std::is_sorted(data.data(), inc.sorted_end()), "iter=", iter);
+
+        if (iter == 0) {
+            allocations = context.allocations();
+        } else {
+            die_unless_equal(context.allocations(), allocations, "iter=", iter);
+        }
+    }
+}
+
+int main() {
+    for(size_t N : {0, 1, 100, 256, 257, 1000, 100000}) {
+        test_blocks<Bitonic::SimdAdapter::SignedInt32>(N, std::numeric_limits<int32_t>::max());
+        test_blocks<Bitonic::SimdAdapter::SignedInt32>(N, 3);
+        test_blocks<Bitonic::SimdAdapter::UnsignedInt32>(N, std::numeric_limits<uint32_t>::max());
+        test_blocks<Bitonic::SimdAdapter::UnsignedInt32>(N, 0);
+    }
+
+    test_prefix<Bitonic::SimdAdapter::SignedInt32>();
+    test_prefix<Bitonic::SimdAdapter::UnsignedInt32>();
+
+    test_no_allocation<Bitonic::SimdAdapter::SignedInt32>();
+
+    return 0;
+}
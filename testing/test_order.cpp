@@ -0,0 +1,76 @@
+#include <bitonic/simd/simd_sort.hpp>
+#include <bitonic/simd/int32.hpp>
+#include <bitonic/simd/int64.hpp>
+#include "helper.hpp"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+std::mt19937_64 prng{7};
+
+template <typename SimdOps, typename Order>
+void test_order(const char* name) {
+    using value_type = typename SimdOps::value_type;
+    using Sort = Bitonic::SimdSort<SimdOps, Order>;
+
+    std::cout << "test_order            <" << name << ", " << SimdOps::name() << ">\n";
+
+    std::uniform_int_distribution<value_type> distr;
+    Bitonic::SortContext context;
+
+    auto check = [&] (const std::vector<value_type>& data, std::vector<value_type> ref, const char* entry) {
+        std::stable_sort(ref.begin(), ref.end(), Order::template less<value_type>);
+        die_unless(data == ref, entry, " N=", data.size());
+    };
+
+    for(size_t N : {size_t(1), size_t(2), size_t(3), size_t(4), size_t(5), size_t(8), size_t(9),
+                    size_t(17), size_t(100), Sort::kMaxElements, size_t(1000), size_t(100000)}) {
+        std::vector<value_type> input(N);
+        std::generate(input.begin(), input.end(), [&] { return distr(prng); });
+
+        if (N <= Sort::kMaxElements) {
+            auto data = input;
+            Sort::sort(data.data(), data.data() + N);
+            check(data, input, "sort");
+
+            data = input;
+            Sort::sort_range(data.data() + 1, data.data() + N);
+            data.erase(data.begin());
+            check(data, std::vector<value_type>(input.begin() + 1, input.end()), "sort_range");
+        }
+
+        auto data = input;
+        Sort::sort_range(data, context);
+        check(data, input, "sort_range with context");
+
+        data = input;
+        Sort::sort_adaptive(data, context);
+        check(data, input, "sort_adaptive");
+
+        // presorted in the opposite direction
+        std::sort(data.begin(), data.end(), [] (value_type a, value_type b) {return Order::less(b, a);});
+        auto reversed = data;
+        Sort::sort_adaptive(data, context);
+        check(data, reversed, "sort_adaptive reversed");
+    }
+}
+
+template <typename SimdOps>
+void test_all_orders() {
+    test_order<SimdOps, Bitonic::Ascending>("Ascending");
+    test_order<SimdOps, Bitonic::Descending>("Descending");
+    test_order<SimdOps, Bitonic::Order<true, Bitonic::FlipSignKey>>("Ascending, FlipSignKey");
+    test_order<SimdOps, Bitonic::Order<false, Bitonic::FlipSignKey>>("Descending, FlipSignKey");
+    test_order<SimdOps, Bitonic::Order<true, Bitonic::InvertKey>>("Ascending, InvertKey");
+    test_order<SimdOps, Bitonic::Order<true, Bitonic::XorKey<0xff00>>>("Ascending, XorKey<0xff00>");
+}
+
+int main() {
+    test_all_orders<Bitonic::SimdAdapter::SignedInt32>();
+    test_all_orders<Bitonic::SimdAdapter::UnsignedInt32>();
+    test_all_orders<Bitonic::SimdAdapter::SignedInt32x4>();
+    test_all_orders<Bitonic::SimdAdapter::UnsignedInt64>();
+
+    return 0;
+}
@@ -0,0 +1,142 @@
+#include <bitonic/simd/simd_sort.hpp>
+#include <bitonic/simd/int32.hpp>
+#include "helper.hpp"
+
+#include <algorithm>
+#include <array>
+#include <deque>
+#include <list>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+std::mt19937_64 prng{1};
+
+template <typename SimdOps, size_t kStreamThreshold>
+void test_random_offsets() {
+    using value_type = typename SimdOps::value_type;
+    using Sort = Bitonic::SimdSort<SimdOps>;
+
+    std::cout << "test_random_offsets   <" << SimdOps::name() << ", " << kStreamThreshold << ">\n";
+
+    constexpr size_t kPacking = SimdOps::kPacking;
+    std::uniform_int_distribution<value_type> distr;
+
+    std::vector<value_type> buffer(Sort::kMaxElements + 4 * kPacking);
+    auto base = align_pointer(buffer.data(), sizeof(typename SimdOps::simd_type)) + kPacking;
+
+    for(size_t N = 1; N <= Sort::kMaxElements; N++) {
+        for (size_t offset = 0; offset != kPacking; offset++) {
+            for (size_t iter = 0; iter != 20; iter++) {
+                std::generate(buffer.begin(), buffer.end(), [&] { return distr(prng); });
+                const std::vector<value_type> before(buffer);
+
+                auto begin = base + offset;
+                Sort::template sort_range<kStreamThreshold>(begin, begin + N);
+
+                std::vector<value_type> ref(before.begin() + (begin - buffer.data()),
+                                            before.begin() + (begin - buffer.data()) + N);
+                std::sort(ref.begin(), ref.end());
+
+                for (size_t i = 0; i != N; i++)
+                    die_unless_equal(begin[i], ref[i], "N=", N, " offset=", offset);
+
+                // elements around the range must not be touched
+                for (auto it = buffer.data(); it != begin; it++)
+                    die_unless_equal(*it, before[it - buffer.data()], "Head");
+                for (auto it = begin + N; it != buffer.data() + buffer.size(); it++)
+                    die_unless_equal(*it, before[it - buffer.data()], "Tail");
+            }
+        }
+    }
+}
+
+template <typename SimdOps>
+void test_vector() {
+    using value_type = typename SimdOps::value_type;
+    using Sort = Bitonic::SimdSort<SimdOps>;
+
+    std::cout << "test_vector           <" << SimdOps::name() << ">\n";
+
+    std::uniform_int_distribution<value_type> distr;
+
+    for(size_t N = 0; N <= 4 * Sort::kMaxElements; N += (N < Sort::kMaxElements ? 1 : 97)) {
+        std::vector<value_type> data(N);
+        std::generate(data.begin(), data.end(), [&] { return distr(prng); });
+
+        auto ref = data;
+        std::sort(ref.begin(), ref.end());
+
+        Sort::sort_range(data);
+        die_unless(data == ref, "N=", N);
+    }
+}
+
+template <typename SimdOps>
+void test_large_vector() {
+    using value_type = typename SimdOps::value_type;
+    using Sort = Bitonic::SimdSort<SimdOps>;
+
+    std::cout << "test_large_vector     <" << SimdOps::name() << ">\n";
+
+    for(size_t N : {Sort::kMaxElements + 1, size_t(1000), size_t(100000)}) {
+        std::vector<value_type> data(N);
+        for(size_t i = 0; i != N; i++)
+            data[i] = static_cast<value_type>(N - i);
+
+        // a threshold of zero forces the streaming path
+        auto streamed = data;
+        Sort::template sort_range<0>(streamed);
+        Sort::sort_range(data);
+
+        die_unless(std::is_sorted(data.begin(), data.end()), "N=", N);
+        die_unless(data == streamed, "Streaming N=", N);
+    }
+}
+
+// Ranges without contiguous storage must not compile, as the sort accesses them as a flat array
+template <typename Sort, typename Range, typename = void>
+struct accepts_range : std::false_type {};
+
+template <typename Sort, typename Range>
+struct accepts_range<Sort, Range, std::void_t<decltype(Sort::sort_range(std::declval<Range&>()))>>
+    : std::true_type {};
+
+template <typename Sort, typename Iterator, typename = void>
+struct accepts_iterators : std::false_type {};
+
+template <typename Sort, typename Iterator>
+struct accepts_iterators<Sort, Iterator, std::void_t<decltype(Sort::sort_range(std::declval<Iterator>(), std::declval<Iterator>()))>>
+    : std::true_type {};
+
+using IntSort = Bitonic::SimdSort<Bitonic::SimdAdapter::SignedInt32>;
+static_assert(accepts_range<IntSort, std::vector<int32_t>>::value);
+static_assert(accepts_range<IntSort, std::array<int32_t, 5>>::value);
+static_assert(accepts_range<IntSort, int32_t[5]>::value);
+static_assert(!accepts_range<IntSort, std::deque<int32_t>>::value);
+static_assert(!accepts_range<IntSort, std::list<int32_t>>::value);
+static_assert(!accepts_range<IntSort, std::vector<uint32_t>>::value);
+static_assert(!accepts_range<IntSort, const std::vector<int32_t>>::value);
+
+static_assert(accepts_iterators<IntSort, int32_t*>::value);
+static_assert(!accepts_iterators<IntSort, std::deque<int32_t>::iterator>::value);
+static_assert(!accepts_iterators<IntSort, std::vector<int32_t>::iterator>::value);
+
+int main() {
+    test_random_offsets<Bitonic::SimdAdapter::SignedInt32, Bitonic::SimdSort<Bitonic::SimdAdapter::SignedInt32>::kDefaultStreamThreshold>();
+    test_random_offsets<Bitonic::SimdAdapter::SignedInt32, 0>();
+    test_random_offsets<Bitonic::SimdAdapter::UnsignedInt32, Bitonic::SimdSort<Bitonic::SimdAdapter::UnsignedInt32>::kDefaultStreamThreshold>();
+    test_random_offsets<Bitonic::SimdAdapter::UnsignedInt32, 0>();
+
+    test_random_offsets<Bitonic::SimdAdapter::SignedInt32x4, 0>();
+    test_random_offsets<Bitonic::SimdAdapter::UnsignedInt32x4, 0>();
+
+    test_vector<Bitonic::SimdAdapter::SignedInt32>();
+    test_vector<Bitonic::SimdAdapter::UnsignedInt32>();
+    test_vector<Bitonic::SimdAdapter::SignedInt32x4>();
+
+    test_large_vector<Bitonic::SimdAdapter::SignedInt32>();
+    test_large_vector<Bitonic::SimdAdapter::UnsignedInt32x4>();
+
+    return 0;
+}
@@ -106,13 +106,11 @@ void test_random_elements(size_t N) {
     }
 }
 
-template <typename T>
-void test_all_by_type() {
-    using SimdOps = typename Bitonic::SimdAdapter::Select<T>::type;
-
+template <typename SimdOps>
+void test_all_by_ops() {
     for(size_t N : {4,5,6,7,8,9,10,11,12,13,14,15,16,17,18,19,20,
                     24, 32, 40, 48, 56, 64, 120, 128, 192, 256}) {
-        if (N < SimdOps::kPacking) continue;
+        if (N < Bitonic::SimdAdapter::Narrow<SimdOps>::type::kPacking) continue;
         if (N / SimdOps::kPacking > 32) continue;
 
         test_sorted_1toN<SimdOps>(N);
@@ -127,9 +125,19 @@ void test_all_by_type() {
     std::cout << "\n\n";
 }
 
+template <typename T>
+void test_all_by_type() {
+    test_all_by_ops<typename Bitonic::SimdAdapter::Select<T>::type>();
+}
+
 int main() {
     test_all_by_type<int32_t>();
     test_all_by_type<uint32_t>();
+    test_all_by_type<int64_t>();
+    test_all_by_type<uint64_t>();
+
+    test_all_by_ops<Bitonic::SimdAdapter::SignedInt32x4>();
+    test_all_by_ops<Bitonic::SimdAdapter::UnsignedInt32x4>();
 
     return 0;
 }
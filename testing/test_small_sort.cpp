@@ -0,0 +1,106 @@
+#include <bitonic/small_sort.hpp>
+#include <bitonic/simd/int32.hpp>
+#include <bitonic/simd/int64.hpp>
+#include "helper.hpp"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+std::mt19937_64 prng{6};
+
+template <typename SimdOps>
+void test_zero_one(size_t N) {
+    using value_type = typename SimdOps::value_type;
+
+    std::cout << "test_zero_one         <" << N << ", " << SimdOps::name() << ">\n";
+
+    // all 2^N zero-one inputs suffice to verify a comparator network
+    const size_t count = size_t(1) << N;
+    std::vector<value_type> data(N * count);
+    for(size_t num = 0; num != count; num++)
+        for(size_t i = 0; i != N; i++)
+            data[num * N + i] = (num >> i) & 1;
+
+    Bitonic::SmallSort<SimdOps>::sort_many(data.data(), N, count);
+
+    for(size_t num = 0; num != count; num++)
+        die_unless(std::is_sorted(data.begin() + num * N, data.begin() + (num + 1) * N), "num=", num);
+}
+
+template <typename SimdOps>
+void test_random(size_t N) {
+    using value_type = typename SimdOps::value_type;
+
+    std::cout << "test_random           <" << N << ", " << SimdOps::name() << ">\n";
+
+    std::uniform_int_distribution<value_type> distr;
+
+    for(size_t count : {1, 3, 8, 11, 1000}) {
+        // the guard behind the arrays must not be touched
+        std::vector<value_type> data(N * count + 16);
+        std::generate(data.begin(), data.end(), [&] { return distr(prng); });
+
+        auto ref = data;
+        for(size_t i = 0; i != count; i++)
+            std::sort(ref.begin() + i * N, ref.begin() + (i + 1) * N);
+
+        Bitonic::SmallSort<SimdOps>::sort_many(data.data(), N, count);
+
+        die_unless(data == ref, "N=", N, " count=", count);
+    }
+}
+
+template <typename SimdOps>
+void test_no_reallocation() {
+    using value_type = typename SimdOps::value_type;
+
+    std::cout << "test_no_reallocation  <" << SimdOps::name() << ">\n";
+
+    std::uniform_int_distribution<value_type> distr;
+    Bitonic::SortContext context;
+    size_t allocations = 0;
+
+    for(size_t iter = 0; iter != 5; iter++) {
+        for(size_t N : {7, 300, 1000}) {
+            std::vector<value_type> data(N * 10);
+            std::generate(data.begin(), data.end(), [&] { return distr(prng); });
+
+            Bitonic::SmallSort<SimdOps>::sort_many(data.data(), N, 10, context);
+            for(size_t i = 0; i != 10; i++)
+                die_unless(std::is_sorted(data.begin() + i * N, data.begin() + (i + 1) * N), "N=", N);
+        }
+
+        if (iter == 0) {
+            allocations = context.allocations();
+            die_unless(allocations > 0);
+        } else {
+            die_unless_equal(context.allocations(), allocations, "iter=", iter);
+        }
+    }
+}
+
+template <typename SimdOps>
+void test_all() {
+    // larger networks are Batcher's, which are built by the same generator as the one for 16
+    for(size_t N = 2; N <= std::min<size_t>(16, Bitonic::SmallSort<SimdOps>::kMaxLength); N++)
+        test_zero_one<SimdOps>(N);
+
+    for(size_t N = 0; N <= 40; N++)
+        test_random<SimdOps>(N);
+
+    // beyond kMaxElements of SimdSort
+    test_random<SimdOps>(300);
+    test_random<SimdOps>(1000);
+}
+
+int main() {
+    test_all<Bitonic::SimdAdapter::SignedInt32>();
+    test_all<Bitonic::SimdAdapter::UnsignedInt32>();
+    test_all<Bitonic::SimdAdapter::UnsignedInt32x4>();
+    test_all<Bitonic::SimdAdapter::SignedInt64>();
+
+    test_no_reallocation<Bitonic::SimdAdapter::SignedInt32>();
+
+    return 0;
+}
@@ -0,0 +1,53 @@
+#include <bitonic/simd/simd_sort.hpp>
+#include <bitonic/simd/int32x4.hpp>
+#include "helper.hpp"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+// This target is compiled with -msse4.1 only; it would silently test nothing new otherwise
+#ifdef __AVX2__
+#error "test_sse must be compiled without AVX2"
+#endif
+
+std::mt19937_64 prng{8};
+
+template <typename SimdOps, typename Order = Bitonic::Ascending>
+void test_sse_range() {
+    using value_type = typename SimdOps::value_type;
+    using Sort = Bitonic::SimdSort<SimdOps, Order>;
+
+    std::cout << "test_sse_range        <" << SimdOps::name() << ", ascending=" << Order::kAscending << ">\n";
+
+    std::uniform_int_distribution<value_type> distr;
+    Bitonic::SortContext context;
+
+    for(size_t N : {0, 1, 2, 3, 4, 5, 7, 8, 13, 31, 64, 100, 127, 128, 129, 1000, 100000}) {
+        for(size_t offset = 0; offset != SimdOps::kPacking; offset++) {
+            std::vector<value_type> buffer(N + offset + 1);
+            std::generate(buffer.begin(), buffer.end(), [&] { return distr(prng); });
+
+            auto begin = buffer.data() + offset;
+            std::vector<value_type> ref(begin, begin + N);
+            std::sort(ref.begin(), ref.end(), Order::template less<value_type>);
+
+            const auto last_value = buffer.back();
+            auto copy = buffer;
+            Sort::sort_range(begin, begin + N);
+            Sort::sort_range(copy.data() + offset, copy.data() + offset + N, context);
+
+            die_unless(std::equal(ref.begin(), ref.end(), begin), "N=", N, " offset=", offset);
+            die_unless(buffer == copy, "Context N=", N, " offset=", offset);
+            die_unless_equal(buffer.back(), last_value, "Last value");
+        }
+    }
+}
+
+int main() {
+    test_sse_range<Bitonic::SimdAdapter::SignedInt32x4>();
+    test_sse_range<Bitonic::SimdAdapter::UnsignedInt32x4>();
+    test_sse_range<Bitonic::SimdAdapter::SignedInt32x4, Bitonic::Descending>();
+
+    return 0;
+}
@@ -0,0 +1,93 @@
+#include <bitonic/string_sort.hpp>
+#include "helper.hpp"
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+std::mt19937_64 prng{4};
+
+static std::string random_string(size_t max_length, char max_char) {
+    std::uniform_int_distribution<size_t> length_distr{0, max_length};
+    std::uniform_int_distribution<int> char_distr{0, max_char};
+
+    std::string str(length_distr(prng), '\0');
+    for(auto& c : str)
+        c = static_cast<char>(char_distr(prng));
+    return str;
+}
+
+void test_random(size_t N, size_t max_length, char max_char, const std::string& common_prefix) {
+    std::cout << "test_random           <" << N << ", " << max_length << ", "
+              << int(max_char) << ", " << common_prefix.size() << ">\n";
+
+    std::vector<std::string> data(N);
+    for(auto& str : data)
+        str = common_prefix + random_string(max_length, max_char);
+
+    auto ref = data;
+    std::sort(ref.begin(), ref.end());
+
+    Bitonic::SortContext context;
+    Bitonic::StringSort::sort(data, context);
+
+    for(size_t i = 0; i != N; i++)
+        die_unless(data[i] == ref[i], "Mismatch at ", i);
+}
+
+void test_stable() {
+    std::cout << "test_stable\n";
+
+    std::vector<std::string> storage;
+    for(size_t i = 0; i != 1000; i++)
+        storage.push_back(random_string(10, 2));
+
+    std::vector<std::string_view> data(storage.begin(), storage.end());
+    auto ref = data;
+    std::stable_sort(ref.begin(), ref.end());
+
+    Bitonic::SortContext context;
+    Bitonic::StringSort::sort(data, context);
+
+    for(size_t i = 0; i != data.size(); i++)
+        die_unless(data[i].data() == ref[i].data(), "Unstable at ", i);
+}
+
+// long runs sharing a chunk with a few exhausted strings must still be refined correctly
+void test_prefixes(size_t N) {
+    std::cout << "test_prefixes         <" << N << ">\n";
+
+    const std::string prefix = "/usr/share/";
+    std::vector<std::string> storage;
+    for(size_t i = 0; i != N; i++) {
+        storage.push_back(prefix + random_string(12, 127));
+        if (i % 97 == 0)
+            storage.push_back(prefix.substr(0, i % prefix.size()) + std::string(i % 3, '\0'));
+    }
+
+    std::vector<std::string_view> data(storage.begin(), storage.end());
+    auto ref = data;
+    std::stable_sort(ref.begin(), ref.end());
+
+    Bitonic::SortContext context;
+    Bitonic::StringSort::sort(data, context);
+
+    for(size_t i = 0; i != data.size(); i++)
+        die_unless(data[i].data() == ref[i].data(), "Mismatch at ", i);
+}
+
+int main() {
+    for(size_t N : {0, 1, 2, 17, 255, 1000, 20000}) {
+        test_random(N, 12, 127, "");
+        test_random(N, 12, 2, "");
+        test_random(N, 3, 127, "");
+        test_random(N, 20, 127, "/usr/share/");
+    }
+
+    test_stable();
+    test_prefixes(1000);
+    test_prefixes(50000);
+
+    return 0;
+}